@@ -0,0 +1,118 @@
+/*
+ * XFCE Launcher - icon atlas benchmark
+ *
+ * Times how long the icon cache takes to produce the icons of the first
+ * page and of every application, once decoding them from the icon theme
+ * (no atlas, as on the first start after an icon change) and once from
+ * the mapped icon atlas (every later start). Needs a display; under a
+ * headless session run it through xvfb-run.
+ *
+ * Note that GtkIconTheme keeps a small LRU of its own, so only the first
+ * cold pass over a page is fully cold; the all-icons figure is the more
+ * telling one.
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <glib/gstdio.h>
+
+#define ITERATIONS 5
+
+/* Resolve every icon in icons, returns milliseconds for the first page
+ * in page_ms and for all of them */
+static gdouble time_icons(LauncherPlugin *launcher, GPtrArray *icons, gint scale, gdouble *page_ms) {
+    gint64 start = g_get_monotonic_time();
+
+    for (guint i = 0; i < icons->len; i++) {
+        icon_cache_lookup(launcher, g_ptr_array_index(icons, i), DEFAULT_ICON_SIZE, scale);
+        if (i + 1 == MIN(icons->len, DEFAULT_GRID_COLUMNS * DEFAULT_GRID_ROWS))
+            *page_ms = (g_get_monotonic_time() - start) / 1000.0;
+    }
+
+    return (g_get_monotonic_time() - start) / 1000.0;
+}
+
+int main(int argc, char **argv) {
+    Catalog catalog = { 0 };
+    LauncherPlugin launcher = { .catalog = &catalog };
+    GPtrArray *icons;
+    GHashTable *seen;
+    GPtrArray *apps;
+    gchar *cache_home;
+    gchar *atlas_path;
+    gdouble cold_page = 0, cold_all = 0, warm_page = 0, warm_all = 0;
+    gint scale;
+    int iterations = argc > 1 ? atoi(argv[1]) : ITERATIONS;
+
+    if (iterations <= 0)
+        iterations = ITERATIONS;
+
+    if (!gtk_init_check(&argc, &argv)) {
+        g_print("skipped=no-display\n");
+        return 0;
+    }
+
+    /* Keep the user's real cache out of it */
+    cache_home = g_dir_make_tmp("xfce-launcher-bench-XXXXXX", NULL);
+    g_setenv("XDG_CACHE_HOME", cache_home, TRUE);
+
+    /* Distinct icons in display order */
+    apps = load_applications_enhanced(FALSE);
+    icons = g_ptr_array_new();
+    seen = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for (guint i = 0; i < apps->len; i++) {
+        AppInfo *app = g_ptr_array_index(apps, i);
+        if (app->icon && g_hash_table_add(seen, (gpointer)app->icon))
+            g_ptr_array_add(icons, (gpointer)app->icon);
+    }
+
+    launcher.button = gtk_button_new();
+    scale = gtk_widget_get_scale_factor(launcher.button);
+    atlas_path = icon_atlas_get_path(DEFAULT_ICON_SIZE, scale);
+
+    for (int i = 0; i < iterations; i++) {
+        gdouble page_ms;
+
+        g_unlink(atlas_path);
+        icon_cache_new(launcher.catalog);
+        cold_all += time_icons(&launcher, icons, scale, &page_ms);
+        cold_page += page_ms;
+        icon_cache_write_atlas(launcher.catalog, FALSE);
+        icon_cache_free(launcher.catalog);
+
+        icon_cache_new(launcher.catalog);
+        warm_all += time_icons(&launcher, icons, scale, &page_ms);
+        warm_page += page_ms;
+        icon_cache_free(launcher.catalog);
+    }
+
+    g_print("icons=%u scale=%d iterations=%d\n", icons->len, scale, iterations);
+    g_print("decode_page_ms_avg=%.3f decode_all_ms_avg=%.3f\n",
+            cold_page / iterations, cold_all / iterations);
+    g_print("atlas_page_ms_avg=%.3f atlas_all_ms_avg=%.3f\n",
+            warm_page / iterations, warm_all / iterations);
+    g_print("speedup=%.1fx\n", warm_all > 0 ? cold_all / warm_all : 0.0);
+
+    g_unlink(atlas_path);
+    g_free(atlas_path);
+    atlas_path = app_cache_get_path();
+    g_unlink(atlas_path);
+    for (int i = 0; i < 3; i++) {
+        gchar *dir = g_path_get_dirname(atlas_path);
+        g_rmdir(dir);
+        g_free(atlas_path);
+        atlas_path = dir;
+    }
+    g_free(atlas_path);
+    g_free(cache_home);
+
+    gtk_widget_destroy(launcher.button);
+    g_hash_table_destroy(seen);
+    g_ptr_array_unref(icons);
+    g_ptr_array_unref(apps);
+
+    return 0;
+}
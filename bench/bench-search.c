@@ -0,0 +1,149 @@
+/*
+ * XFCE Launcher - search benchmark
+ *
+ * Types a few queries one character at a time against a synthetic catalog
+ * (10000 entries by default) and compares the old per-keystroke scan
+ * (g_utf8_strdown + strstr + g_list_append) with the search index. The
+ * index also scores generic names, keywords, exec names and categories,
+ * so it does more work per entry than the scan it is measured against.
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <string.h>
+
+#define CATALOG_SIZE 10000
+#define ITERATIONS 20
+
+static const gchar *words[] = {
+    "Fire", "Text", "Office", "Media", "Player", "Editor", "Viewer", "Terminal",
+    "Image", "Sound", "Mail", "Chat", "Browser", "Calendar", "Manager", "Studio",
+    "Writer", "Draw", "Paint", "Monitor", "Settings", "Archive", "Disk", "Network",
+    "Über", "Café", "Screen", "Record", "Photo", "Music", "Video", "Game", NULL
+};
+
+static const gchar *generic_names[] = {
+    "Web Browser", "Text Editor", "Terminal Emulator", "Image Viewer", "Media Player",
+    "Document Viewer", "File Manager", "Email Client", NULL
+};
+
+static const gchar *queries[] = {
+    "firefox", "terminal", "café", "zzz", "media player", "browser", "pdf", "ffx", NULL
+};
+
+static GPtrArray* make_catalog(guint n) {
+    GPtrArray *apps = app_array_new();
+    guint n_words = g_strv_length((gchar **)words);
+    guint n_generic = g_strv_length((gchar **)generic_names);
+    GRand *rand = g_rand_new_with_seed(42);
+
+    for (guint i = 0; i < n; i++) {
+        const gchar *a = words[g_rand_int_range(rand, 0, n_words)];
+        const gchar *b = words[g_rand_int_range(rand, 0, n_words)];
+        const gchar *generic_name = generic_names[g_rand_int_range(rand, 0, n_generic)];
+        gchar *name = g_strdup_printf("%s %s %u", a, b, i);
+        gchar *keywords = g_strdup_printf("%s %s", b, a);
+        gchar *exec = g_strdup_printf("/usr/bin/%s-%u %%U", a, i);
+
+        /* The entry the queries are after */
+        if (i == 0) {
+            g_free(name);
+            name = g_strdup("Firefox Web Browser");
+            g_free(keywords);
+            keywords = g_strdup("Internet WWW Web PDF");
+        }
+
+        g_ptr_array_add(apps, app_info_new(name, exec, NULL, NULL, NULL,
+                                           generic_name, keywords, "Utility;"));
+        g_free(exec);
+        g_free(keywords);
+        g_free(name);
+    }
+
+    g_rand_free(rand);
+    return apps;
+}
+
+/* The scan on_search_changed() used before the index */
+static GList* naive_search(GPtrArray *apps, const gchar *search_text) {
+    GList *filtered = NULL;
+    gchar *search_lower = g_utf8_strdown(search_text, -1);
+
+    for (guint i = 0; i < apps->len; i++) {
+        AppInfo *app_info = g_ptr_array_index(apps, i);
+        if (app_info && app_info->name && !app_info->is_hidden) {
+            gchar *name_lower = g_utf8_strdown(app_info->name, -1);
+            if (strstr(name_lower, search_lower) != NULL)
+                filtered = g_list_append(filtered, app_info);
+            g_free(name_lower);
+        }
+    }
+
+    g_free(search_lower);
+    return filtered;
+}
+
+/* Type every query a character at a time, returns total milliseconds */
+static gdouble type_queries(LauncherPlugin *launcher, gboolean indexed, guint *keystrokes) {
+    gint64 start = g_get_monotonic_time();
+
+    *keystrokes = 0;
+    for (int q = 0; queries[q] != NULL; q++) {
+        const gchar *end = queries[q];
+
+        while (*end) {
+            gchar *prefix;
+
+            end = g_utf8_next_char(end);
+            prefix = g_strndup(queries[q], end - queries[q]);
+            if (indexed)
+                g_ptr_array_unref(search_index_query(launcher, prefix));
+            else
+                g_list_free(naive_search(launcher->catalog->apps, prefix));
+            g_free(prefix);
+            (*keystrokes)++;
+        }
+    }
+
+    return (g_get_monotonic_time() - start) / 1000.0;
+}
+
+int main(int argc, char **argv) {
+    Catalog catalog = { 0 };
+    LauncherPlugin launcher = { .catalog = &catalog };
+    guint n = argc > 1 ? (guint)atoi(argv[1]) : CATALOG_SIZE;
+    gdouble naive_ms = 0, indexed_ms = 0, build_ms = 0;
+    guint keystrokes = 0;
+
+    if (n == 0)
+        n = CATALOG_SIZE;
+    launcher.catalog->apps = make_catalog(n);
+
+    for (int i = 0; i < ITERATIONS; i++) {
+        gint64 start;
+
+        naive_ms += type_queries(&launcher, FALSE, &keystrokes);
+
+        /* The first query after a list change pays for the rebuild */
+        search_index_invalidate(launcher.catalog);
+        start = g_get_monotonic_time();
+        g_ptr_array_unref(search_index_query(&launcher, "x"));
+        build_ms += (g_get_monotonic_time() - start) / 1000.0;
+
+        indexed_ms += type_queries(&launcher, TRUE, &keystrokes);
+    }
+
+    g_print("entries=%u keystrokes=%u iterations=%d\n", n, keystrokes, ITERATIONS);
+    g_print("naive_us_per_key=%.1f\n", naive_ms * 1000.0 / ITERATIONS / keystrokes);
+    g_print("indexed_us_per_key=%.1f\n", indexed_ms * 1000.0 / ITERATIONS / keystrokes);
+    g_print("index_build_ms=%.3f\n", build_ms / ITERATIONS);
+    g_print("speedup=%.1fx\n", indexed_ms > 0 ? naive_ms / indexed_ms : 0.0);
+
+    search_index_free(launcher.catalog->search_index);
+    g_ptr_array_unref(launcher.catalog->apps);
+
+    return 0;
+}
@@ -0,0 +1,618 @@
+/*
+ * XFCE Launcher - benchmark suite on synthetic corpora
+ *
+ * Generates application directories of 100, 1000 and 10000 .desktop
+ * files (or the sizes given on the command line) and, for each, measures
+ * the loader cold and warm, saving and loading the layout (layout.bin,
+ * and config.xml imported) with many folders and hidden applications,
+ * thousands of reorders through the configuration journal, search per
+ * keystroke, page population, stepping through the continuous scroll
+ * view and the memory taken by the application list, after a scan with
+ * and without memory-lean mode and after a warm load. Every corpus runs
+ * in a child process of its own, since GLib caches the XDG directories
+ * for the lifetime of a process. Output is one "size=N metric=value" line
+ * per result.
+ *
+ * Startup time and resident memory are then measured for 1 and 4 launcher
+ * instances, each configuration in a fresh child: "shared" attaches the
+ * instances to one catalog as the panel now does, "separate" gives every
+ * instance a catalog of its own like the former one-process-per-instance
+ * setup. Separate processes also paid for their own GTK and panel
+ * wrapper, which is not counted here, so those figures are a lower bound.
+ *
+ * Page population and the instance runs need a display; without one those
+ * metrics are reported as skipped. Run through xvfb-run, or with GDK_BACKEND=broadway
+ * and a running broadwayd, on headless machines.
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <glib/gstdio.h>
+#include <string.h>
+
+#define ITERATIONS 5
+#define REORDERS   2000         /* drops recorded in the journal */
+#define REWRITES   50           /* drops followed by a full config.xml rewrite */
+#define SCROLL_VIEWPORT 1080    /* pixels */
+#define SCROLL_STEP     16
+
+static const guint default_sizes[] = { 100, 1000, 10000 };
+static const guint instance_counts[] = { 1, 4 };
+
+static const gchar *words[] = {
+    "Fire", "Text", "Office", "Media", "Player", "Editor", "Viewer", "Terminal",
+    "Image", "Sound", "Mail", "Chat", "Browser", "Calendar", "Manager", "Studio",
+    "Writer", "Draw", "Paint", "Monitor", "Settings", "Archive", "Disk", "Network",
+    "Über", "Café", "Screen", "Record", "Photo", "Music", "Video", "Game", NULL
+};
+
+static const gchar *categories[] = {
+    "Utility;", "Development;IDE;", "Graphics;", "AudioVideo;Player;", "Network;WebBrowser;",
+    "Office;WordProcessor;", "Game;", "System;TerminalEmulator;", NULL
+};
+
+static const gchar *icons[] = {
+    "application-x-executable", "utilities-terminal", "text-editor", "web-browser",
+    "multimedia-player", "accessories-calculator", "system-file-manager", NULL
+};
+
+static const gchar *queries[] = { "firefox", "terminal", "café", "zzz", "media player", "brw", NULL };
+
+static void report(guint size, const gchar *metric, gdouble value) {
+    g_print("size=%u %s=%.3f\n", size, metric, value);
+}
+
+static void report_skipped(guint size, const gchar *metric, const gchar *reason) {
+    g_print("size=%u %s=skipped-%s\n", size, metric, reason);
+}
+
+/* Resident set size in KiB, from /proc/self/status */
+static glong resident_kb(void) {
+    gchar *status = NULL;
+    glong kb = -1;
+    
+    if (g_file_get_contents("/proc/self/status", &status, NULL, NULL)) {
+        gchar *line = strstr(status, "VmRSS:");
+        
+        if (line)
+            kb = strtol(line + strlen("VmRSS:"), NULL, 10);
+        g_free(status);
+    }
+    return kb;
+}
+
+static void write_corpus(const gchar *root, guint size) {
+    gchar *apps_dir = g_build_filename(root, "data", "applications", NULL);
+    guint n_words = g_strv_length((gchar **)words);
+    GRand *rand = g_rand_new_with_seed(size);
+    
+    g_mkdir_with_parents(apps_dir, 0700);
+    
+    for (guint i = 0; i < size; i++) {
+        const gchar *a = words[g_rand_int_range(rand, 0, n_words)];
+        const gchar *b = words[g_rand_int_range(rand, 0, n_words)];
+        gchar *name = g_strdup_printf("synthetic-%05u.desktop", i);
+        gchar *path = g_build_filename(apps_dir, name, NULL);
+        gchar *contents = g_strdup_printf(
+            "[Desktop Entry]\n"
+            "Type=Application\n"
+            "Name=%s %s %u\n"
+            "GenericName=%s %s\n"
+            "Keywords=%s;%s;synthetic;\n"
+            "Exec=synthetic-%s-%u %%U\n"
+            "Icon=%s\n"
+            "Categories=%s\n",
+            i == 0 ? "Firefox Web" : a, i == 0 ? "Browser" : b, i, b, a, a, b,
+            a, i, icons[i % (G_N_ELEMENTS(icons) - 1)],
+            categories[i % (G_N_ELEMENTS(categories) - 1)]);
+        
+        g_file_set_contents(path, contents, -1, NULL);
+        g_free(contents);
+        g_free(path);
+        g_free(name);
+    }
+    
+    g_rand_free(rand);
+    g_free(apps_dir);
+}
+
+static void remove_tree(const gchar *path) {
+    GDir *dir = g_dir_open(path, 0, NULL);
+    
+    if (dir) {
+        const gchar *name;
+        
+        while ((name = g_dir_read_name(dir)) != NULL) {
+            gchar *child = g_build_filename(path, name, NULL);
+            
+            remove_tree(child);
+            g_free(child);
+        }
+        g_dir_close(dir);
+        g_rmdir(path);
+    } else {
+        g_unlink(path);
+    }
+}
+
+/* Loader, cold then warm, returns the warm list */
+static GPtrArray* bench_loader(guint size) {
+    gchar *cache_path = app_cache_get_path();
+    gdouble warm_min = G_MAXDOUBLE;
+    GPtrArray *apps, *scanned[2];
+    gint64 start;
+    glong rss_before, rss_after;
+    
+    g_unlink(cache_path);
+    start = g_get_monotonic_time();
+    apps = load_applications_enhanced(FALSE);
+    report(size, "loader_cold_ms", (g_get_monotonic_time() - start) / 1000.0);
+    report(size, "apps", apps->len);
+    g_ptr_array_unref(apps);
+    
+    for (int i = 0; i < ITERATIONS; i++) {
+        start = g_get_monotonic_time();
+        apps = load_applications_enhanced(FALSE);
+        warm_min = MIN(warm_min, (g_get_monotonic_time() - start) / 1000.0);
+        g_ptr_array_unref(apps);
+    }
+    report(size, "loader_warm_ms", warm_min);
+    
+    /* A fresh scan with the parsed desktop files kept or released. Both
+     * lists stay alive so the second one cannot reuse freed memory. */
+    for (gint lean = 0; lean < 2; lean++) {
+        g_unlink(cache_path);
+        rss_before = resident_kb();
+        scanned[lean] = load_applications_enhanced(lean);
+        rss_after = resident_kb();
+        if (rss_before >= 0 && rss_after >= 0)
+            report(size, lean ? "scan_lean_rss_kb" : "scan_rss_kb", rss_after - rss_before);
+    }
+    
+    /* Footprint of the list the panel keeps */
+    rss_before = resident_kb();
+    apps = load_applications_enhanced(FALSE);
+    rss_after = resident_kb();
+    if (rss_before >= 0 && rss_after >= 0)
+        report(size, "app_list_rss_kb", rss_after - rss_before);
+    g_ptr_array_unref(scanned[0]);
+    g_ptr_array_unref(scanned[1]);
+    
+    g_free(cache_path);
+    return apps;
+}
+
+/* Back to a pristine list before the saved layout is applied again */
+static void reset_layout(LauncherPlugin *launcher) {
+    g_list_free_full(launcher->catalog->folder_list, (GDestroyNotify)free_folder_info);
+    launcher->catalog->folder_list = NULL;
+    for (guint j = 0; j < launcher->catalog->apps->len; j++) {
+        AppInfo *app = g_ptr_array_index(launcher->catalog->apps, j);
+        
+        app->is_hidden = FALSE;
+        app->position = -1;
+        g_clear_pointer(&app->folder_id, g_free);
+    }
+}
+
+/* Every 20th application in one of size / 100 folders, every 7th hidden,
+ * the first 60 explicitly placed */
+static void bench_config(LauncherPlugin *launcher, guint size) {
+    guint n_folders = MAX(size / 100, 1);
+    gdouble save_min = G_MAXDOUBLE, load_min = G_MAXDOUBLE, xml_min = G_MAXDOUBLE;
+    gdouble legacy_min = G_MAXDOUBLE;
+    guint i = 0, entries = 0;
+    gchar *snapshot, *legacy, *config_path, *config_dir, *journal_path;
+    GRegex *app_id;
+    
+    launcher->catalog->config_loaded = TRUE;
+    rebuild_application_index(launcher->catalog);
+    
+    for (guint f = 0; f < n_folders; f++) {
+        FolderInfo *folder = create_folder("Synthetic folder");
+        
+        g_free(folder->id);
+        folder->id = g_strdup_printf("folder_%u", f);
+        launcher->catalog->folder_list = g_list_append(launcher->catalog->folder_list, folder);
+    }
+    
+    for (i = 0; i < launcher->catalog->apps->len; i++) {
+        AppInfo *app = g_ptr_array_index(launcher->catalog->apps, i);
+        
+        if (i % 7 == 3)
+            app->is_hidden = TRUE;
+        if (i % 20 == 5) {
+            gchar *folder_id = g_strdup_printf("folder_%u", (i / 20) % n_folders);
+            
+            add_app_to_folder(launcher, app, folder_id);
+            g_free(folder_id);
+        }
+        if (i < 60)
+            app->position = i;
+        if (app->is_hidden || app->folder_id || app->position != -1)
+            entries++;
+    }
+    
+    for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+        gint64 start = g_get_monotonic_time();
+        
+        save_configuration(launcher);
+        config_store_sync(launcher->catalog);
+        save_min = MIN(save_min, (g_get_monotonic_time() - start) / 1000.0);
+        
+        reset_layout(launcher);
+        start = g_get_monotonic_time();
+        load_configuration(launcher);
+        load_min = MIN(load_min, (g_get_monotonic_time() - start) / 1000.0);
+    }
+    
+    config_path = get_config_file_path();
+    config_dir = g_path_get_dirname(config_path);
+    journal_path = g_build_filename(config_dir, "config.journal", NULL);
+    g_free(config_dir);
+    snapshot = config_build_snapshot(launcher->catalog, 0);
+    app_id = g_regex_new("<app id=\"[^\"]*\"", 0, 0, NULL);
+    legacy = g_regex_replace_literal(app_id, snapshot, -1, 0, "<app", 0, NULL);
+    config_store_sync(launcher->catalog);
+    g_unlink(journal_path);
+    
+    /* A config.xml newer than layout.bin is imported instead */
+    for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+        gint64 start;
+        
+        g_file_set_contents(config_path, snapshot, -1, NULL);
+        reset_layout(launcher);
+        start = g_get_monotonic_time();
+        load_configuration(launcher);
+        xml_min = MIN(xml_min, (g_get_monotonic_time() - start) / 1000.0);
+    }
+    
+    /* The same layout keyed by display name, as written before desktop ids */
+    for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+        gint64 start;
+        
+        g_file_set_contents(config_path, legacy, -1, NULL);
+        reset_layout(launcher);
+        start = g_get_monotonic_time();
+        load_configuration(launcher);
+        legacy_min = MIN(legacy_min, (g_get_monotonic_time() - start) / 1000.0);
+    }
+    
+    report(size, "config_folders", n_folders);
+    report(size, "config_entries", entries);
+    report(size, "config_save_ms", save_min);
+    report(size, "config_load_ms", load_min);
+    report(size, "config_load_xml_ms", xml_min);
+    report(size, "config_load_by_name_ms", legacy_min);
+    
+    g_regex_unref(app_id);
+    g_free(legacy);
+    g_free(snapshot);
+    g_free(journal_path);
+    g_free(config_path);
+}
+
+/* One drop on empty grid space, as on_drag_drop() does it */
+static void reorder(LauncherPlugin *launcher, GRand *rand) {
+    GPtrArray *apps = launcher->catalog->apps;
+    guint old_index = g_rand_int_range(rand, 0, apps->len);
+    guint new_index = g_rand_int_range(rand, 0, apps->len);
+    AppInfo *app = g_ptr_array_steal_index(apps, old_index);
+    
+    g_ptr_array_insert(apps, MIN(new_index, apps->len), app);
+    config_record_move(launcher, app, MIN(new_index, apps->len - 1));
+    recalculate_positions(launcher);
+}
+
+/* Rapid reorders written through the journal, against rewriting the
+ * whole config.xml after every drop as before; then a load that has to
+ * replay what is left in the journal */
+static void bench_reorders(LauncherPlugin *launcher, guint size) {
+    GRand *rand = g_rand_new_with_seed(7);
+    gint64 start;
+    
+    start = g_get_monotonic_time();
+    for (int i = 0; i < REORDERS; i++)
+        reorder(launcher, rand);
+    config_store_sync(launcher->catalog);
+    report(size, "config_reorder_journal_us", (gdouble)(g_get_monotonic_time() - start) / REORDERS);
+    
+    reset_layout(launcher);
+    start = g_get_monotonic_time();
+    load_configuration(launcher);
+    report(size, "config_load_journal_ms", (g_get_monotonic_time() - start) / 1000.0);
+    
+    start = g_get_monotonic_time();
+    for (int i = 0; i < REWRITES; i++) {
+        reorder(launcher, rand);
+        save_configuration(launcher);
+        config_store_sync(launcher->catalog);
+    }
+    report(size, "config_reorder_rewrite_us", (gdouble)(g_get_monotonic_time() - start) / REWRITES);
+    
+    g_rand_free(rand);
+}
+
+static void bench_search(LauncherPlugin *launcher, guint size) {
+    guint keystrokes = 0;
+    gint64 start;
+    
+    search_index_invalidate(launcher->catalog);
+    start = g_get_monotonic_time();
+    g_ptr_array_unref(search_index_query(launcher, "x"));
+    report(size, "search_index_build_ms", (g_get_monotonic_time() - start) / 1000.0);
+    
+    start = g_get_monotonic_time();
+    for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+        for (int q = 0; queries[q] != NULL; q++) {
+            const gchar *end = queries[q];
+            
+            while (*end) {
+                gchar *prefix;
+                
+                end = g_utf8_next_char(end);
+                prefix = g_strndup(queries[q], end - queries[q]);
+                g_ptr_array_unref(search_index_query(launcher, prefix));
+                g_free(prefix);
+                keystrokes++;
+            }
+        }
+    }
+    report(size, "search_us_per_key", (gdouble)(g_get_monotonic_time() - start) / keystrokes);
+}
+
+/* The continuous scroll view from top to bottom in SCROLL_STEP pixel
+ * steps, as smooth scrolling delivers them; a step that brings a new row
+ * into view rebinds the tiles */
+static void bench_scroll(LauncherPlugin *launcher, guint size) {
+    GtkAdjustment *vadjustment;
+    gdouble end;
+    guint steps = 0;
+    gint64 start;
+    
+    launcher->continuous_scroll = TRUE;
+    create_overlay_window(launcher);
+    vadjustment = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(launcher->scrolled_window));
+    
+    /* The window is never shown, stand in for a 1080 pixel high screen */
+    gtk_adjustment_set_page_size(vadjustment, SCROLL_VIEWPORT);
+    end = MAX(gtk_adjustment_get_upper(vadjustment) - SCROLL_VIEWPORT, 0);
+    
+    start = g_get_monotonic_time();
+    for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+        for (gdouble value = 0; value <= end; value += SCROLL_STEP) {
+            gtk_adjustment_set_value(vadjustment, value);
+            steps++;
+        }
+        gtk_adjustment_set_value(vadjustment, 0);
+    }
+    report(size, "scroll_step_us", (gdouble)(g_get_monotonic_time() - start) / steps);
+    report(size, "scroll_tiles", launcher->app_tiles->len + launcher->folder_tiles->len);
+    
+    destroy_overlay_window(launcher);
+    launcher->continuous_scroll = FALSE;
+}
+
+static void bench_pages(LauncherPlugin *launcher, guint size, gboolean have_display) {
+    gint64 start;
+    gint pages;
+    
+    if (!have_display) {
+        report_skipped(size, "overlay_create_ms", "no-display");
+        report_skipped(size, "page_populate_us", "no-display");
+        report_skipped(size, "scroll_step_us", "no-display");
+        report_skipped(size, "scroll_tiles", "no-display");
+        return;
+    }
+    
+    catalog_fill_view(launcher);
+    icon_cache_new(launcher->catalog);
+    
+    start = g_get_monotonic_time();
+    create_overlay_window(launcher);
+    report(size, "overlay_create_ms", (g_get_monotonic_time() - start) / 1000.0);
+    
+    /* Rebinding the tiles only, nothing is drawn */
+    pages = MAX(launcher->total_pages, 1);
+    start = g_get_monotonic_time();
+    for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+        for (gint page = 0; page < pages; page++) {
+            launcher->current_page = page;
+            populate_current_page(launcher);
+        }
+    }
+    report(size, "page_populate_us", (gdouble)(g_get_monotonic_time() - start) / (ITERATIONS * pages));
+    destroy_overlay_window(launcher);
+    
+    bench_scroll(launcher, size);
+    icon_cache_free(launcher->catalog);
+}
+
+/* Child: run every benchmark against the corpus the environment points at */
+static int run_corpus(int argc, char **argv, guint size) {
+    Catalog catalog = { 0 };
+    LauncherPlugin launcher = { .catalog = &catalog };
+    gboolean have_display = gtk_init_check(&argc, &argv);
+    
+    launcher.catalog->apps = bench_loader(size);
+    launcher.filtered = g_ptr_array_new();
+    bench_config(&launcher, size);
+    bench_reorders(&launcher, size);
+    bench_search(&launcher, size);
+    bench_pages(&launcher, size, have_display);
+    
+    search_index_free(launcher.catalog->search_index);
+    config_store_free(launcher.catalog);
+    g_hash_table_destroy(launcher.catalog->app_index);
+    if (launcher.catalog->geometries)
+        g_hash_table_destroy(launcher.catalog->geometries);
+    g_ptr_array_unref(launcher.filtered);
+    g_list_free_full(launcher.catalog->folder_list, (GDestroyNotify)free_folder_info);
+    g_ptr_array_unref(launcher.catalog->apps);
+    return 0;
+}
+
+/* Child: start n instances as the panel would with lazy startup disabled:
+ * the catalog services, the complete application list, then an overlay each */
+static int run_instances(int argc, char **argv, guint size, guint n, gboolean shared) {
+    const gchar *mode = shared ? "shared" : "separate";
+    gchar *metric;
+    LauncherPlugin **views;
+    glong rss_before, rss_after;
+    gint64 start;
+    gboolean loading;
+    
+    if (!gtk_init_check(&argc, &argv)) {
+        metric = g_strdup_printf("instances_%u_%s_startup_ms", n, mode);
+        report_skipped(size, metric, "no-display");
+        g_free(metric);
+        return 0;
+    }
+    
+    views = g_new0(LauncherPlugin *, n);
+    rss_before = resident_kb();
+    start = g_get_monotonic_time();
+    
+    for (guint i = 0; i < n; i++) {
+        views[i] = g_new0(LauncherPlugin, 1);
+        views[i]->button = gtk_button_new();
+        if (shared) {
+            catalog_attach(views[i]);
+        } else {
+            /* What every instance used to hold for itself */
+            views[i]->catalog = g_slice_new0(Catalog);
+            views[i]->catalog->ref_count = 1;
+            views[i]->catalog->apps = app_array_new();
+            views[i]->catalog->recent_desktop_info = g_queue_new();
+            views[i]->catalog->views = g_list_append(NULL, views[i]);
+            views[i]->filtered = g_ptr_array_new();
+        }
+        catalog_start_services(views[i]->catalog);
+    }
+    
+    do {
+        g_main_context_iteration(NULL, TRUE);
+        loading = FALSE;
+        for (guint i = 0; i < n; i++)
+            loading |= views[i]->catalog->loader != NULL || !views[i]->catalog->config_loaded;
+    } while (loading);
+    
+    for (guint i = 0; i < n; i++)
+        create_overlay_window(views[i]);
+    while (g_main_context_pending(NULL))
+        g_main_context_iteration(NULL, FALSE);
+    
+    metric = g_strdup_printf("instances_%u_%s_startup_ms", n, mode);
+    report(size, metric, (g_get_monotonic_time() - start) / 1000.0);
+    g_free(metric);
+    
+    rss_after = resident_kb();
+    if (rss_before >= 0 && rss_after >= 0) {
+        metric = g_strdup_printf("instances_%u_%s_rss_kb", n, mode);
+        report(size, metric, rss_after - rss_before);
+        g_free(metric);
+    }
+    
+    for (guint i = 0; i < n; i++) {
+        destroy_overlay_window(views[i]);
+        g_ptr_array_unref(views[i]->filtered);
+        catalog_detach(views[i]);
+        gtk_widget_destroy(views[i]->button);
+        g_free(views[i]);
+    }
+    g_free(views);
+    return 0;
+}
+
+static gboolean spawn_child(const gchar *self, guint size, gchar **argv, gchar **envp) {
+    gint status = 0;
+    GError *error = NULL;
+    gboolean ok;
+    
+    argv[0] = (gchar *)self;
+    ok = g_spawn_sync(NULL, argv, envp, G_SPAWN_CHILD_INHERITS_STDIN, NULL, NULL,
+                      NULL, NULL, &status, &error);
+    if (!ok) {
+        g_printerr("size=%u failed: %s\n", size, error->message);
+        g_error_free(error);
+    } else if (status != 0) {
+        g_printerr("size=%u failed: benchmark exited abnormally\n", size);
+        ok = FALSE;
+    }
+    return ok;
+}
+
+static gboolean spawn_corpus(const gchar *self, guint size) {
+    gchar *root = g_dir_make_tmp("xfce-launcher-suite-XXXXXX", NULL);
+    gchar **envp = g_get_environ();
+    gchar *size_arg = g_strdup_printf("%u", size);
+    gchar *argv[] = { NULL, "--corpus", size_arg, NULL };
+    gchar *data_home, *empty, *config_home, *cache_home;
+    gboolean ok;
+    
+    write_corpus(root, size);
+    
+    data_home = g_build_filename(root, "data", NULL);
+    empty = g_build_filename(root, "empty", NULL);
+    config_home = g_build_filename(root, "config", NULL);
+    cache_home = g_build_filename(root, "cache", NULL);
+    
+    /* Keep the host's applications, settings and caches out of it */
+    envp = g_environ_setenv(envp, "XDG_DATA_HOME", data_home, TRUE);
+    envp = g_environ_setenv(envp, "XDG_DATA_DIRS", empty, TRUE);
+    envp = g_environ_setenv(envp, "XDG_CONFIG_HOME", config_home, TRUE);
+    envp = g_environ_setenv(envp, "XDG_CACHE_HOME", cache_home, TRUE);
+    envp = g_environ_setenv(envp, "HOME", root, TRUE);
+    
+    ok = spawn_child(self, size, argv, envp);
+    
+    /* One process per configuration, so their footprints do not mix */
+    for (guint i = 0; ok && i < G_N_ELEMENTS(instance_counts); i++) {
+        gchar *count_arg = g_strdup_printf("%u", instance_counts[i]);
+        gchar *shared_argv[] = { NULL, "--instances", size_arg, count_arg, "shared", NULL };
+        gchar *separate_argv[] = { NULL, "--instances", size_arg, count_arg, "separate", NULL };
+        
+        ok = spawn_child(self, size, shared_argv, envp) &&
+             spawn_child(self, size, separate_argv, envp);
+        g_free(count_arg);
+    }
+    
+    remove_tree(root);
+    g_free(cache_home);
+    g_free(config_home);
+    g_free(empty);
+    g_free(data_home);
+    g_free(size_arg);
+    g_strfreev(envp);
+    g_free(root);
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    gchar *self;
+    gboolean ok = TRUE;
+    
+    if (argc == 3 && strcmp(argv[1], "--corpus") == 0)
+        return run_corpus(argc, argv, (guint)atoi(argv[2]));
+    if (argc == 5 && strcmp(argv[1], "--instances") == 0)
+        return run_instances(argc, argv, (guint)atoi(argv[2]), (guint)atoi(argv[3]),
+                             strcmp(argv[4], "shared") == 0);
+    
+    self = g_file_read_link("/proc/self/exe", NULL);
+    if (!self)
+        self = g_strdup(argv[0]);
+    
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++)
+            ok &= atoi(argv[i]) > 0 && spawn_corpus(self, (guint)atoi(argv[i]));
+    } else {
+        for (guint i = 0; i < G_N_ELEMENTS(default_sizes); i++)
+            ok &= spawn_corpus(self, default_sizes[i]);
+    }
+    
+    g_free(self);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,551 @@
+/*
+ * XFCE Launcher Plugin v0.7
+ *
+ * Changelog:
+ * - Hotkey setting to toggle the launcher (integrates with XFCE custom keyboard shortcuts)
+ * - Drag & drop improvements: reorder apps, create folders, add apps to folders
+ * - Search result highlighting (matched text in app names is highlighted)
+ * - Responsive layout: grid size, icon size, and spacing adapt to the current screen resolution
+ * - Settings dialog updated (includes hotkey configuration)
+ * - Configuration saving is more robust (XML attribute escaping)
+ * - Fixed broken drag-and-drop behavior
+ * - Fixed potential memory leak when loading configuration (folder id replacement)
+ * - Fixed callback type mismatches and reduced build warnings
+
+ * Persistent application index cache
+ *
+ * The loaded application list is written to a compact binary file in
+ * $XDG_CACHE_HOME so the next panel start can restore it with a single
+ * mmap instead of parsing every .desktop file. The file records the
+ * ordered list of application directories and the current desktop, the
+ * mtime of every application directory and the mtime and size of every
+ * .desktop file found in them; any difference invalidates the cache.
+ * The stat data is an AppScan taken while discovery reads the
+ * directories, before any entry is parsed, so a file that changes in
+ * between leaves the cache stale rather than valid with old contents.
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <glib/gstdio.h>
+#include <string.h>
+
+#define APP_CACHE_MAGIC     0x43414c58  /* "XLAC" */
+#define APP_CACHE_VERSION   3
+#define APP_CACHE_NO_STRING G_MAXUINT32
+
+/* On-disk layout: header, directory records, file records, app records,
+ * string table. All offsets are relative to the start of the file,
+ * string references are offsets into the string table. */
+typedef struct {
+    guint32 magic;
+    guint32 version;
+    guint32 locale;
+    guint32 search_path;    /* application directories in precedence order, '\n' separated */
+    guint32 desktop;        /* XDG_CURRENT_DESKTOP, filtered on by OnlyShowIn/NotShowIn */
+    guint32 n_dirs;
+    guint32 n_files;
+    guint32 n_apps;
+    guint32 strings_offset;
+    guint32 strings_size;
+} CacheHeader;
+
+typedef struct {
+    guint32 path;
+    guint32 padding;
+    gint64  mtime;          /* nanoseconds, -1 if the directory did not exist */
+} CacheDir;
+
+typedef struct {
+    guint32 path;
+    guint32 padding;
+    gint64  mtime;
+    guint64 size;
+} CacheFile;
+
+typedef struct {
+    guint32 name;
+    guint32 exec;
+    guint32 icon;
+    guint32 desktop_id;
+    guint32 filename;
+    guint32 generic_name;
+    guint32 keywords;
+    guint32 categories;
+    guint32 padding;
+} CacheApp;
+
+/* Builder state used while writing */
+typedef struct {
+    GArray     *dirs;
+    GArray     *files;
+    GByteArray *strings;
+    GHashTable *string_offsets;
+} CacheWriter;
+
+gchar* app_cache_get_path(void) {
+    return g_build_filename(g_get_user_cache_dir(), "xfce4", "launcher", "applications.cache", NULL);
+}
+
+static gint64 stat_mtime(const GStatBuf *st) {
+    return (gint64)st->st_mtim.tv_sec * G_GINT64_CONSTANT(1000000000) + st->st_mtim.tv_nsec;
+}
+
+static const gchar* current_locale(void) {
+    const gchar * const *languages = g_get_language_names();
+    return languages && languages[0] ? languages[0] : "C";
+}
+
+/* Entries are filtered on the desktop environment by g_app_info_should_show() */
+static const gchar* current_desktop(void) {
+    const gchar *desktop = g_getenv("XDG_CURRENT_DESKTOP");
+    return desktop ? desktop : "";
+}
+
+/* The directories discovery reads, as one string */
+static gchar* join_search_path(gchar **dirs) {
+    return g_strjoinv("\n", dirs);
+}
+
+static guint32 writer_add_string(CacheWriter *writer, const gchar *str) {
+    gpointer offset;
+
+    if (!str)
+        return APP_CACHE_NO_STRING;
+
+    if (g_hash_table_lookup_extended(writer->string_offsets, str, NULL, &offset))
+        return GPOINTER_TO_UINT(offset);
+
+    guint32 new_offset = writer->strings->len;
+    g_byte_array_append(writer->strings, (const guint8 *)str, strlen(str) + 1);
+    g_hash_table_insert(writer->string_offsets, g_strdup(str), GUINT_TO_POINTER(new_offset));
+
+    return new_offset;
+}
+
+/* Stat data of one path */
+typedef struct {
+    gchar  *path;
+    gint64  mtime;          /* nanoseconds, -1 if the path did not exist */
+    guint64 size;
+} ScanRecord;
+
+struct _AppScan {
+    gchar **search_path;    /* get_application_dirs() when the scan started */
+    GArray *dirs;           /* ScanRecord */
+    GArray *files;          /* ScanRecord */
+};
+
+static void scan_record_clear(gpointer data) {
+    g_free(((ScanRecord *)data)->path);
+}
+
+static GArray* scan_records_new(void) {
+    GArray *records = g_array_new(FALSE, FALSE, sizeof(ScanRecord));
+
+    g_array_set_clear_func(records, scan_record_clear);
+    return records;
+}
+
+/* A new, empty scan of search_path, NULL for a part of a scan */
+AppScan* app_scan_new(gchar **search_path) {
+    AppScan *scan = g_new0(AppScan, 1);
+
+    scan->search_path = g_strdupv(search_path);
+    scan->dirs = scan_records_new();
+    scan->files = scan_records_new();
+    return scan;
+}
+
+void app_scan_free(AppScan *scan) {
+    if (!scan)
+        return;
+
+    g_strfreev(scan->search_path);
+    g_array_unref(scan->dirs);
+    g_array_unref(scan->files);
+    g_free(scan);
+}
+
+static void scan_records_append(GArray *dest, GArray *src) {
+    for (guint i = 0; i < src->len; i++) {
+        ScanRecord record = g_array_index(src, ScanRecord, i);
+
+        record.path = g_strdup(record.path);
+        g_array_append_val(dest, record);
+    }
+}
+
+AppScan* app_scan_copy(AppScan *scan) {
+    AppScan *copy = app_scan_new(scan->search_path);
+
+    scan_records_append(copy->dirs, scan->dirs);
+    scan_records_append(copy->files, scan->files);
+    return copy;
+}
+
+/* Add the records of src to dest */
+void app_scan_append(AppScan *dest, AppScan *src) {
+    scan_records_append(dest->dirs, src->dirs);
+    scan_records_append(dest->files, src->files);
+}
+
+/* The directories the scan was started for, owned by the scan */
+gchar** app_scan_get_search_path(AppScan *scan) {
+    return scan->search_path;
+}
+
+/* The directories that were read, in the order they were read */
+gchar** app_scan_get_dirs(AppScan *scan) {
+    GPtrArray *dirs = g_ptr_array_new();
+
+    for (guint i = 0; i < scan->dirs->len; i++) {
+        ScanRecord *record = &g_array_index(scan->dirs, ScanRecord, i);
+
+        if (record->mtime != -1)
+            g_ptr_array_add(dirs, g_strdup(record->path));
+    }
+    g_ptr_array_add(dirs, NULL);
+    return (gchar **)g_ptr_array_free(dirs, FALSE);
+}
+
+static gint64 scan_add(GArray *records, const gchar *path) {
+    ScanRecord record = { 0 };
+    GStatBuf st;
+
+    record.path = g_strdup(path);
+    record.mtime = (g_stat(path, &st) == 0) ? stat_mtime(&st) : -1;
+    record.size = record.mtime != -1 ? (guint64)st.st_size : 0;
+    g_array_append_val(records, record);
+    return record.mtime;
+}
+
+/* Record a directory about to be read, returns whether it exists */
+gboolean app_scan_add_dir(AppScan *scan, const gchar *path) {
+    return scan_add(scan->dirs, path) != -1;
+}
+
+/* Record a .desktop file about to be parsed */
+void app_scan_add_file(AppScan *scan, const gchar *path) {
+    /* Gone already, discovery will not find it either */
+    if (scan_add(scan->files, path) == -1)
+        g_array_remove_index(scan->files, scan->files->len - 1);
+}
+
+/* Stat a directory and the .desktop files directly in it again, before
+ * changed entries in it are parsed again */
+void app_scan_restamp_dir(AppScan *scan, const gchar *path) {
+    GDir *dir;
+    const gchar *name;
+    guint i;
+
+    for (i = 0; i < scan->dirs->len; i++) {
+        if (strcmp(g_array_index(scan->dirs, ScanRecord, i).path, path) == 0) {
+            g_array_remove_index_fast(scan->dirs, i);
+            break;
+        }
+    }
+    for (i = scan->files->len; i > 0; i--) {
+        ScanRecord *record = &g_array_index(scan->files, ScanRecord, i - 1);
+        gchar *parent = g_path_get_dirname(record->path);
+
+        if (strcmp(parent, path) == 0)
+            g_array_remove_index_fast(scan->files, i - 1);
+        g_free(parent);
+    }
+
+    if (!app_scan_add_dir(scan, path))
+        return;
+
+    dir = g_dir_open(path, 0, NULL);
+    if (!dir)
+        return;
+
+    while ((name = g_dir_read_name(dir)) != NULL) {
+        if (g_str_has_suffix(name, ".desktop")) {
+            gchar *child = g_build_filename(path, name, NULL);
+
+            app_scan_add_file(scan, child);
+            g_free(child);
+        }
+    }
+    g_dir_close(dir);
+}
+
+static void writer_add_records(CacheWriter *writer, GArray *records, gboolean files) {
+    for (guint i = 0; i < records->len; i++) {
+        ScanRecord *record = &g_array_index(records, ScanRecord, i);
+
+        if (files) {
+            CacheFile file_record = { 0 };
+
+            file_record.path = writer_add_string(writer, record->path);
+            file_record.mtime = record->mtime;
+            file_record.size = record->size;
+            g_array_append_val(writer->files, file_record);
+        } else {
+            CacheDir dir_record = { 0 };
+
+            dir_record.path = writer_add_string(writer, record->path);
+            dir_record.mtime = record->mtime;
+            g_array_append_val(writer->dirs, dir_record);
+        }
+    }
+}
+
+/* Write app_list with the stat data of the scan it was parsed after */
+void app_cache_save(GPtrArray *app_list, AppScan *scan) {
+    CacheWriter writer;
+    CacheHeader header = { 0 };
+    GArray *apps;
+    GByteArray *data;
+    gchar *search_path;
+    gchar *cache_path;
+    gchar *cache_dir;
+    GError *error = NULL;
+
+    writer.dirs = g_array_new(FALSE, FALSE, sizeof(CacheDir));
+    writer.files = g_array_new(FALSE, FALSE, sizeof(CacheFile));
+    writer.strings = g_byte_array_new();
+    writer.string_offsets = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    apps = g_array_new(FALSE, FALSE, sizeof(CacheApp));
+
+    header.magic = APP_CACHE_MAGIC;
+    header.version = APP_CACHE_VERSION;
+    header.locale = writer_add_string(&writer, current_locale());
+    header.desktop = writer_add_string(&writer, current_desktop());
+
+    search_path = join_search_path(scan->search_path);
+    header.search_path = writer_add_string(&writer, search_path);
+    g_free(search_path);
+    writer_add_records(&writer, scan->dirs, FALSE);
+    writer_add_records(&writer, scan->files, TRUE);
+
+    for (guint i = 0; i < app_list->len; i++) {
+        AppInfo *app = g_ptr_array_index(app_list, i);
+        CacheApp app_record = { 0 };
+
+        app_record.name = writer_add_string(&writer, app->name);
+        app_record.exec = writer_add_string(&writer, app->exec);
+        app_record.icon = writer_add_string(&writer, app->icon);
+        app_record.desktop_id = writer_add_string(&writer, app->desktop_id);
+        app_record.filename = writer_add_string(&writer, app->filename);
+        app_record.generic_name = writer_add_string(&writer, app->generic_name);
+        app_record.keywords = writer_add_string(&writer, app->keywords);
+        app_record.categories = writer_add_string(&writer, app->categories);
+        g_array_append_val(apps, app_record);
+    }
+
+    header.n_dirs = writer.dirs->len;
+    header.n_files = writer.files->len;
+    header.n_apps = apps->len;
+    header.strings_offset = sizeof(CacheHeader) +
+                            writer.dirs->len * sizeof(CacheDir) +
+                            writer.files->len * sizeof(CacheFile) +
+                            apps->len * sizeof(CacheApp);
+    header.strings_size = writer.strings->len;
+
+    data = g_byte_array_sized_new(header.strings_offset + header.strings_size);
+    g_byte_array_append(data, (const guint8 *)&header, sizeof(CacheHeader));
+    g_byte_array_append(data, (const guint8 *)writer.dirs->data, writer.dirs->len * sizeof(CacheDir));
+    g_byte_array_append(data, (const guint8 *)writer.files->data, writer.files->len * sizeof(CacheFile));
+    g_byte_array_append(data, (const guint8 *)apps->data, apps->len * sizeof(CacheApp));
+    g_byte_array_append(data, writer.strings->data, writer.strings->len);
+
+    cache_path = app_cache_get_path();
+    cache_dir = g_path_get_dirname(cache_path);
+    g_mkdir_with_parents(cache_dir, 0700);
+
+    if (!g_file_set_contents(cache_path, (const gchar *)data->data, data->len, &error)) {
+        g_warning("Failed to write application cache: %s", error->message);
+        g_error_free(error);
+    }
+
+    g_free(cache_dir);
+    g_free(cache_path);
+    g_byte_array_free(data, TRUE);
+    g_array_free(apps, TRUE);
+    g_hash_table_destroy(writer.string_offsets);
+    g_byte_array_free(writer.strings, TRUE);
+    g_array_free(writer.files, TRUE);
+    g_array_free(writer.dirs, TRUE);
+}
+
+typedef struct {
+    GPtrArray *apps;
+    AppScan *scan;
+} CacheSnapshot;
+
+static void cache_snapshot_free(CacheSnapshot *snapshot) {
+    g_ptr_array_unref(snapshot->apps);
+    app_scan_free(snapshot->scan);
+    g_free(snapshot);
+}
+
+static void app_cache_save_thread(GTask *task,
+                                  gpointer source_object,
+                                  gpointer task_data,
+                                  GCancellable *cancellable) {
+    CacheSnapshot *snapshot = (CacheSnapshot *)task_data;
+
+    app_cache_save(snapshot->apps, snapshot->scan);
+    g_task_return_boolean(task, TRUE);
+}
+
+/* Write the cache from a worker thread. Only the cached fields are
+ * copied, the caller's list and scan may change right after this returns. */
+void app_cache_save_async(GPtrArray *app_list, AppScan *scan) {
+    CacheSnapshot *snapshot = g_new0(CacheSnapshot, 1);
+    GTask *task;
+
+    snapshot->apps = app_array_new();
+    snapshot->scan = app_scan_copy(scan);
+    for (guint i = 0; i < app_list->len; i++) {
+        AppInfo *app = g_ptr_array_index(app_list, i);
+        g_ptr_array_add(snapshot->apps, app_info_new(app->name, app->exec, app->icon,
+                                                     app->desktop_id, app->filename,
+                                                     app->generic_name, app->keywords,
+                                                     app->categories));
+    }
+
+    task = g_task_new(NULL, NULL, NULL, NULL);
+    g_task_set_task_data(task, snapshot, (GDestroyNotify)cache_snapshot_free);
+    g_task_run_in_thread(task, app_cache_save_thread);
+    g_object_unref(task);
+}
+
+/* Resolve a string reference, returns NULL for out of range offsets */
+static const gchar* cache_string(const gchar *strings, const CacheHeader *header, guint32 offset) {
+    if (offset == APP_CACHE_NO_STRING || offset >= header->strings_size)
+        return NULL;
+    return strings + offset;
+}
+
+/* Restore the application list if the cache is still valid. scan, if not
+ * NULL, receives the stat data the cache was checked against. */
+GPtrArray* app_cache_load(AppScan **scan) {
+    GMappedFile *mapped;
+    const gchar *contents;
+    const CacheHeader *header;
+    const CacheDir *dirs;
+    const CacheFile *files;
+    const CacheApp *apps;
+    const gchar *strings;
+    gchar *cache_path;
+    gsize length;
+    gsize records_size;
+    GPtrArray *app_list;
+    gchar **search_dirs;
+    gchar *search_path;
+    gboolean same_search_path;
+    GStatBuf st;
+    guint32 i;
+
+    cache_path = app_cache_get_path();
+    mapped = g_mapped_file_new(cache_path, FALSE, NULL);
+    g_free(cache_path);
+    if (!mapped)
+        return NULL;
+
+    contents = g_mapped_file_get_contents(mapped);
+    length = g_mapped_file_get_length(mapped);
+    if (length < sizeof(CacheHeader))
+        goto invalid;
+
+    header = (const CacheHeader *)contents;
+    if (header->magic != APP_CACHE_MAGIC || header->version != APP_CACHE_VERSION)
+        goto invalid;
+
+    records_size = sizeof(CacheHeader) +
+                   (gsize)header->n_dirs * sizeof(CacheDir) +
+                   (gsize)header->n_files * sizeof(CacheFile) +
+                   (gsize)header->n_apps * sizeof(CacheApp);
+    if (header->strings_offset != records_size ||
+        (gsize)header->strings_offset + header->strings_size != length ||
+        header->strings_size == 0 ||
+        contents[length - 1] != '\0')
+        goto invalid;
+
+    dirs = (const CacheDir *)(contents + sizeof(CacheHeader));
+    files = (const CacheFile *)(dirs + header->n_dirs);
+    apps = (const CacheApp *)(files + header->n_files);
+    strings = contents + header->strings_offset;
+
+    /* Display names are localized */
+    if (g_strcmp0(cache_string(strings, header, header->locale), current_locale()) != 0)
+        goto invalid;
+
+    /* A new Flatpak or Nix profile changes the directories, a new session
+     * the desktop environment, without touching any recorded mtime */
+    if (g_strcmp0(cache_string(strings, header, header->desktop), current_desktop()) != 0)
+        goto invalid;
+
+    search_dirs = get_application_dirs();
+    search_path = join_search_path(search_dirs);
+    same_search_path = g_strcmp0(cache_string(strings, header, header->search_path), search_path) == 0;
+    g_free(search_path);
+    g_strfreev(search_dirs);
+    if (!same_search_path)
+        goto invalid;
+
+    /* Added, removed or renamed entries change the directory mtime */
+    for (i = 0; i < header->n_dirs; i++) {
+        const gchar *path = cache_string(strings, header, dirs[i].path);
+        gint64 mtime = (path && g_stat(path, &st) == 0) ? stat_mtime(&st) : -1;
+        if (!path || mtime != dirs[i].mtime)
+            goto invalid;
+    }
+
+    /* Entries edited in place only show up on the file itself */
+    for (i = 0; i < header->n_files; i++) {
+        const gchar *path = cache_string(strings, header, files[i].path);
+        if (!path || g_stat(path, &st) != 0 ||
+            stat_mtime(&st) != files[i].mtime || (guint64)st.st_size != files[i].size)
+            goto invalid;
+    }
+
+    if (scan) {
+        *scan = app_scan_new(NULL);
+        (*scan)->search_path = g_strsplit(cache_string(strings, header, header->search_path), "\n", -1);
+        for (i = 0; i < header->n_dirs; i++) {
+            ScanRecord record = { 0 };
+
+            record.path = g_strdup(cache_string(strings, header, dirs[i].path));
+            record.mtime = dirs[i].mtime;
+            g_array_append_val((*scan)->dirs, record);
+        }
+        for (i = 0; i < header->n_files; i++) {
+            ScanRecord record = { 0 };
+
+            record.path = g_strdup(cache_string(strings, header, files[i].path));
+            record.mtime = files[i].mtime;
+            record.size = files[i].size;
+            g_array_append_val((*scan)->files, record);
+        }
+    }
+
+    /* Records are stored in display order */
+    app_list = g_ptr_array_new_full(header->n_apps, (GDestroyNotify)free_app_info);
+    for (i = 0; i < header->n_apps; i++) {
+        g_ptr_array_add(app_list, app_info_new(cache_string(strings, header, apps[i].name),
+                                               cache_string(strings, header, apps[i].exec),
+                                               cache_string(strings, header, apps[i].icon),
+                                               cache_string(strings, header, apps[i].desktop_id),
+                                               cache_string(strings, header, apps[i].filename),
+                                               cache_string(strings, header, apps[i].generic_name),
+                                               cache_string(strings, header, apps[i].keywords),
+                                               cache_string(strings, header, apps[i].categories)));
+    }
+
+    g_mapped_file_unref(mapped);
+
+    return app_list;
+
+invalid:
+    g_debug("Application cache is stale, rescanning desktop files");
+    g_mapped_file_unref(mapped);
+    return NULL;
+}
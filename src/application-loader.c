@@ -27,9 +27,11 @@
  */
 
 #include "xfce-launcher.h"
+#include "settings.h"
 #include <gio/gio.h>
+#include <string.h>
 
-/* Directory paths to monitor */
+/* Directories read besides the XDG data directories, which may not list them */
 static const gchar *desktop_dirs[] = {
     "/usr/share/applications",
     "/usr/local/share/applications",
@@ -38,234 +40,1101 @@ static const gchar *desktop_dirs[] = {
     NULL
 };
 
-/* Get user-specific directories */
-static gchar** get_user_desktop_dirs(void) {
+/* Get every directory the loader reads .desktop files from */
+gchar** get_application_dirs(void) {
     GPtrArray *dirs = g_ptr_array_new();
-    gchar *home = g_strdup(g_get_home_dir());
+    GHashTable *seen = g_hash_table_new(g_str_hash, g_str_equal);
+    const gchar * const *system_dirs = g_get_system_data_dirs();
+    GPtrArray *candidates = g_ptr_array_new_with_free_func(g_free);
     
-    /* User's local applications */
-    g_ptr_array_add(dirs, g_build_filename(home, ".local/share/applications", NULL));
+    /* XDG data directories, as scanned by g_app_info_get_all() */
+    g_ptr_array_add(candidates, g_build_filename(g_get_user_data_dir(), "applications", NULL));
+    for (int i = 0; system_dirs[i] != NULL; i++)
+        g_ptr_array_add(candidates, g_build_filename(system_dirs[i], "applications", NULL));
     
-    /* Snap user applications */
-    g_ptr_array_add(dirs, g_build_filename(home, "snap", NULL));
+    /* Snap and Flatpak export directories */
+    for (int i = 0; desktop_dirs[i] != NULL; i++)
+        g_ptr_array_add(candidates, g_strdup(desktop_dirs[i]));
+    g_ptr_array_add(candidates, g_build_filename(g_get_home_dir(),
+                                                 ".local/share/flatpak/exports/share/applications",
+                                                 NULL));
     
-    /* Flatpak user applications */
-    g_ptr_array_add(dirs, g_build_filename(home, ".local/share/flatpak/exports/share/applications", NULL));
+    /* XDG_DATA_DIRS often already lists the Flatpak exports */
+    for (guint i = 0; i < candidates->len; i++) {
+        gchar *dir = g_ptr_array_index(candidates, i);
+        if (!g_hash_table_contains(seen, dir)) {
+            g_hash_table_add(seen, dir);
+            g_ptr_array_add(dirs, g_strdup(dir));
+        }
+    }
     
-    g_free(home);
+    g_hash_table_destroy(seen);
+    g_ptr_array_unref(candidates);
     g_ptr_array_add(dirs, NULL);
     
     return (gchar**)g_ptr_array_free(dirs, FALSE);
 }
 
-/* Load applications from Snap */
-static void load_snap_applications(GList **app_list) {
-    const gchar *snap_dir = "/var/lib/snapd/desktop/applications";
+/* Build an AppInfo from a desktop entry, taking ownership of desktop_info.
+ * desktop_id is the id it was found under, NULL to ask the entry. In
+ * memory-lean mode the entry is released once the fields are copied out. */
+static AppInfo* app_info_new_from_desktop_info(GDesktopAppInfo *desktop_info, const gchar *desktop_id,
+                                               gboolean memory_lean) {
+    GAppInfo *gapp_info = G_APP_INFO(desktop_info);
+    AppInfo *app_info;
+    const gchar *id = desktop_id ? desktop_id : g_app_info_get_id(gapp_info);
+    const gchar *filename = g_desktop_app_info_get_filename(desktop_info);
+    const gchar *icon = NULL;
+    gchar *basename = NULL;
+    gchar *keywords = NULL;
+    
+    const gchar * const *keyword_list = g_desktop_app_info_get_keywords(desktop_info);
+    if (keyword_list)
+        keywords = g_strjoinv(" ", (gchar **)keyword_list);
+    
+    GIcon *gicon = g_app_info_get_icon(gapp_info);
+    if (gicon && G_IS_THEMED_ICON(gicon)) {
+        const gchar * const *icon_names = g_themed_icon_get_names(G_THEMED_ICON(gicon));
+        if (icon_names && icon_names[0])
+            icon = icon_names[0];
+    }
+    
+    /* Entries loaded by filename have no id, fall back to the basename */
+    if (!id && filename)
+        id = basename = g_path_get_basename(filename);
+    
+    app_info = app_info_new(g_app_info_get_display_name(gapp_info),
+                            g_app_info_get_commandline(gapp_info), icon, id, filename,
+                            g_desktop_app_info_get_generic_name(desktop_info), keywords,
+                            g_desktop_app_info_get_categories(desktop_info));
+    if (memory_lean)
+        g_object_unref(desktop_info);
+    else
+        app_info->desktop_info = desktop_info;
+    
+    g_free(keywords);
+    g_free(basename);
+    return app_info;
+}
+
+/* Background loader shared between the GTask worker and its batches */
+struct _AppLoader {
+    gint            ref_count;
+    Catalog        *catalog;
+    GCancellable   *cancellable;
+    GPtrArray      *apps;          /* main thread only, unused when progressive */
+    gboolean        progressive;   /* batches go straight into catalog->apps */
+    gboolean        memory_lean;   /* copied from the catalog for the worker */
+};
+
+/* Entries handed from the worker to the main loop in one go */
+typedef struct {
+    AppLoader *loader;
+    GPtrArray *apps;
+    AppScan   *scan;      /* final batch only */
+    gboolean   done;
+    gboolean   from_cache;
+} AppBatch;
+
+/* A .desktop file found by enumeration */
+typedef struct {
+    gchar *desktop_id;
+    gchar *path;
+} DesktopFile;
+
+/* One discovery pass: the applications directories are enumerated in
+ * parallel, the files de-duplicated by desktop id and the winners parsed
+ * in parallel. Jobs only write their own slot and the atomic counters. */
+typedef struct {
+    AppLoader   *loader;           /* NULL for synchronous loads */
+    gboolean     memory_lean;
+    gchar      **dirs;             /* in XDG precedence order */
+    GPtrArray  **dir_files;        /* DesktopFile per directory */
+    AppScan    **dir_scans;        /* stat data per directory, taken before parsing */
+    GPtrArray   *winners;          /* DesktopFile, one per desktop id */
+    GPtrArray  **parsed;           /* AppInfo per chunk, synchronous loads only */
+    gint         n_parsed;
+    gint         n_shown;
+} Discovery;
+
+/* Number of entries parsed by one job and streamed to the main loop
+ * together, about a page */
+#define LOADER_BATCH_SIZE (DEFAULT_GRID_COLUMNS * DEFAULT_GRID_ROWS)
+
+static AppLoader* app_loader_ref(AppLoader *loader) {
+    g_atomic_int_inc(&loader->ref_count);
+    return loader;
+}
+
+static void app_loader_unref(AppLoader *loader) {
+    if (!g_atomic_int_dec_and_test(&loader->ref_count))
+        return;
+    
+    if (loader->apps)
+        g_ptr_array_unref(loader->apps);
+    g_object_unref(loader->cancellable);
+    g_free(loader);
+}
+
+static void app_batch_free(gpointer data) {
+    AppBatch *batch = (AppBatch *)data;
+    
+    g_ptr_array_unref(batch->apps);
+    app_scan_free(batch->scan);
+    app_loader_unref(batch->loader);
+    g_free(batch);
+}
+
+static gboolean on_application_batch(gpointer data);
+static void watch_scan(MonitorQueue *queue, AppScan *scan);
+
+/* Hand a sorted batch of entries over to the main loop, the final one with
+ * the scan the entries were read after */
+static void app_loader_deliver(AppLoader *loader, GPtrArray *apps, AppScan *scan,
+                               gboolean done, gboolean from_cache) {
+    AppBatch *batch = g_new0(AppBatch, 1);
+    
+    batch->loader = app_loader_ref(loader);
+    batch->apps = apps;
+    batch->scan = scan;
+    batch->done = done;
+    batch->from_cache = from_cache;
+    
+    /* Below redraw priority so the panel keeps painting while batches arrive */
+    g_main_context_invoke_full(NULL, G_PRIORITY_DEFAULT_IDLE,
+                               on_application_batch, batch, app_batch_free);
+}
+
+/* Move every entry of src to the end of dest */
+static void app_array_move(GPtrArray *dest, GPtrArray *src) {
+    for (guint i = 0; i < src->len; i++)
+        g_ptr_array_add(dest, g_ptr_array_index(src, i));
+    
+    g_ptr_array_set_free_func(src, NULL);
+    g_ptr_array_set_size(src, 0);
+    g_ptr_array_set_free_func(src, (GDestroyNotify)free_app_info);
+}
+
+/* Merge the name sorted entries of src into the name sorted dest, emptying
+ * src. Runs from the back so dest only grows once. */
+static void app_array_merge(GPtrArray *dest, GPtrArray *src) {
+    guint i = dest->len, j = src->len, k;
+    
+    g_ptr_array_set_size(dest, dest->len + src->len);
+    k = dest->len;
+    while (j > 0) {
+        if (i > 0 && compare_app_names(g_ptr_array_index(dest, i - 1), g_ptr_array_index(src, j - 1)) > 0)
+            dest->pdata[--k] = dest->pdata[--i];
+        else
+            dest->pdata[--k] = src->pdata[--j];
+    }
+    
+    g_ptr_array_set_free_func(src, NULL);
+    g_ptr_array_set_size(src, 0);
+    g_ptr_array_set_free_func(src, (GDestroyNotify)free_app_info);
+}
+
+static gboolean discovery_cancelled(Discovery *discovery) {
+    return discovery->loader && g_cancellable_is_cancelled(discovery->loader->cancellable);
+}
+
+static void desktop_file_free(DesktopFile *file) {
+    g_free(file->desktop_id);
+    g_free(file->path);
+    g_slice_free(DesktopFile, file);
+}
+
+/* Desktop id prefix of the files in subdirectory name of a directory whose
+ * files have prefix. Subdirectory names are joined by '-' as in the
+ * desktop entry specification. */
+static gchar* subdir_prefix(const gchar *prefix, const gchar *name) {
+    return g_strconcat(prefix, name, "-", NULL);
+}
+
+/* Collect the .desktop files below path, with desktop ids from the
+ * directory names, see subdir_prefix() */
+static void enumerate_dir(Discovery *discovery, const gchar *path, const gchar *prefix,
+                          guint depth, GPtrArray *files, AppScan *scan) {
     GDir *dir;
-    const gchar *filename;
-    GError *error = NULL;
+    const gchar *name;
     
-    if (!g_file_test(snap_dir, G_FILE_TEST_IS_DIR))
+    /* Stat before reading, a change after this leaves the cache stale */
+    if (!app_scan_add_dir(scan, path))
         return;
     
-    dir = g_dir_open(snap_dir, 0, &error);
-    if (!dir) {
-        if (error) {
-            g_warning("Failed to open snap directory: %s", error->message);
-            g_error_free(error);
-        }
+    dir = g_dir_open(path, 0, NULL);
+    if (!dir)
         return;
-    }
     
-    while ((filename = g_dir_read_name(dir)) != NULL) {
-        if (g_str_has_suffix(filename, ".desktop")) {
-            gchar *desktop_path = g_build_filename(snap_dir, filename, NULL);
-            GDesktopAppInfo *desktop_info = g_desktop_app_info_new_from_filename(desktop_path);
+    while ((name = g_dir_read_name(dir)) != NULL && !discovery_cancelled(discovery)) {
+        gchar *child = g_build_filename(path, name, NULL);
+        
+        if (g_str_has_suffix(name, ".desktop")) {
+            DesktopFile *file = g_slice_new(DesktopFile);
             
-            if (desktop_info && g_app_info_should_show(G_APP_INFO(desktop_info))) {
-                AppInfo *app_info = g_new0(AppInfo, 1);
-                app_info->name = g_strdup(g_app_info_get_display_name(G_APP_INFO(desktop_info)));
-                app_info->exec = g_strdup(g_app_info_get_commandline(G_APP_INFO(desktop_info)));
-                
-                GIcon *gicon = g_app_info_get_icon(G_APP_INFO(desktop_info));
-                if (gicon && G_IS_THEMED_ICON(gicon)) {
-                    const gchar * const *icon_names = g_themed_icon_get_names(G_THEMED_ICON(gicon));
-                    if (icon_names && icon_names[0])
-                        app_info->icon = g_strdup(icon_names[0]);
-                }
-                
-                app_info->desktop_info = desktop_info;
-                app_info->position = -1;
-                *app_list = g_list_prepend(*app_list, app_info);
-            }
+            file->desktop_id = g_strconcat(prefix, name, NULL);
+            file->path = child;
+            g_ptr_array_add(files, file);
+            app_scan_add_file(scan, child);
+            continue;
+        }
+        
+        if (depth < APP_DIR_MAX_DEPTH && g_file_test(child, G_FILE_TEST_IS_DIR)) {
+            gchar *child_prefix = subdir_prefix(prefix, name);
             
-            g_free(desktop_path);
+            enumerate_dir(discovery, child, child_prefix, depth + 1, files, scan);
+            g_free(child_prefix);
         }
+        g_free(child);
     }
     
     g_dir_close(dir);
 }
 
-/* Load applications from Flatpak */
-static void load_flatpak_applications(GList **app_list) {
-    const gchar *flatpak_dirs[] = {
-        "/var/lib/flatpak/exports/share/applications",
-        NULL
-    };
+/* Thread pool job: enumerate one directory, data is its index + 1 */
+static void enumerate_job(gpointer data, gpointer user_data) {
+    Discovery *discovery = (Discovery *)user_data;
+    guint index = GPOINTER_TO_UINT(data) - 1;
+    GPtrArray *files = g_ptr_array_new();
+    AppScan *scan = app_scan_new(NULL);
     
-    /* Also check user flatpak dir */
-    gchar *user_flatpak_dir = g_build_filename(g_get_home_dir(), 
-                                               ".local/share/flatpak/exports/share/applications", 
-                                               NULL);
+    enumerate_dir(discovery, discovery->dirs[index], "", 0, files, scan);
+    discovery->dir_files[index] = files;
+    discovery->dir_scans[index] = scan;
+}
+
+/* Thread pool job: parse one chunk of winners, data is its index + 1 */
+static void parse_job(gpointer data, gpointer user_data) {
+    Discovery *discovery = (Discovery *)user_data;
+    guint chunk = GPOINTER_TO_UINT(data) - 1;
+    guint first = chunk * LOADER_BATCH_SIZE;
+    guint last = MIN(first + LOADER_BATCH_SIZE, discovery->winners->len);
+    GPtrArray *apps = app_array_new();
     
-    for (int i = 0; flatpak_dirs[i] != NULL; i++) {
-        const gchar *flatpak_dir = flatpak_dirs[i];
-        GDir *dir;
-        const gchar *filename;
-        GError *error = NULL;
+    for (guint i = first; i < last && !discovery_cancelled(discovery); i++) {
+        DesktopFile *file = g_ptr_array_index(discovery->winners, i);
+        GDesktopAppInfo *desktop_info = g_desktop_app_info_new_from_filename(file->path);
         
-        if (!g_file_test(flatpak_dir, G_FILE_TEST_IS_DIR))
+        g_atomic_int_inc(&discovery->n_parsed);
+        if (!desktop_info)
             continue;
         
-        dir = g_dir_open(flatpak_dir, 0, &error);
-        if (!dir) {
-            if (error) {
-                g_warning("Failed to open flatpak directory: %s", error->message);
-                g_error_free(error);
-            }
+        if (!g_app_info_should_show(G_APP_INFO(desktop_info)) ||
+            !g_app_info_get_display_name(G_APP_INFO(desktop_info))) {
+            g_object_unref(desktop_info);
             continue;
         }
         
-        while ((filename = g_dir_read_name(dir)) != NULL) {
-            if (g_str_has_suffix(filename, ".desktop")) {
-                gchar *desktop_path = g_build_filename(flatpak_dir, filename, NULL);
-                GDesktopAppInfo *desktop_info = g_desktop_app_info_new_from_filename(desktop_path);
-                
-                if (desktop_info && g_app_info_should_show(G_APP_INFO(desktop_info))) {
-                    AppInfo *app_info = g_new0(AppInfo, 1);
-                    app_info->name = g_strdup(g_app_info_get_display_name(G_APP_INFO(desktop_info)));
-                    app_info->exec = g_strdup(g_app_info_get_commandline(G_APP_INFO(desktop_info)));
-                    
-                    GIcon *gicon = g_app_info_get_icon(G_APP_INFO(desktop_info));
-                    if (gicon && G_IS_THEMED_ICON(gicon)) {
-                        const gchar * const *icon_names = g_themed_icon_get_names(G_THEMED_ICON(gicon));
-                        if (icon_names && icon_names[0])
-                            app_info->icon = g_strdup(icon_names[0]);
-                    }
-                    
-                    app_info->desktop_info = desktop_info;
-                    app_info->position = -1;
-                    *app_list = g_list_prepend(*app_list, app_info);
-                }
-                
-                g_free(desktop_path);
-            }
-        }
-        
-        g_dir_close(dir);
+        g_ptr_array_add(apps, app_info_new_from_desktop_info(desktop_info, file->desktop_id,
+                                                             discovery->memory_lean));
+    }
+    g_atomic_int_add(&discovery->n_shown, apps->len);
+    
+    if (discovery->loader) {
+        g_ptr_array_sort(apps, compare_app_name_entries);
+        app_loader_deliver(discovery->loader, apps, NULL, FALSE, FALSE);
+    } else {
+        discovery->parsed[chunk] = apps;
     }
+}
+
+/* Run jobs 1..n_jobs on a pool sized to the machine and wait for them */
+static void run_jobs(GFunc func, Discovery *discovery, guint n_jobs) {
+    GThreadPool *pool;
+    
+    if (n_jobs == 0)
+        return;
+    
+    pool = g_thread_pool_new(func, discovery, MIN(g_get_num_processors(), n_jobs), FALSE, NULL);
+    for (guint i = 0; i < n_jobs; i++)
+        g_thread_pool_push(pool, GUINT_TO_POINTER(i + 1), NULL);
+    g_thread_pool_free(pool, FALSE, TRUE);
+}
+
+/* Find every application. Returns the sorted list for synchronous loads;
+ * with a loader the entries are streamed in batches instead and NULL is
+ * returned, the final batch is left to the caller. scan receives the stat
+ * data of the directories read, for the application cache. */
+static GPtrArray* discover_applications(AppLoader *loader, gboolean memory_lean, AppScan **scan) {
+    Discovery discovery = { 0 };
+    GHashTable *ids = g_hash_table_new(g_str_hash, g_str_equal);
+    GPtrArray *apps = NULL;
+    guint n_dirs, n_files = 0, n_masked = 0, n_chunks;
+    gint64 start = trace_begin(), parse_start;
     
-    /* Check user flatpak directory */
-    if (g_file_test(user_flatpak_dir, G_FILE_TEST_IS_DIR)) {
-        GDir *dir;
-        const gchar *filename;
-        GError *error = NULL;
+    discovery.loader = loader;
+    discovery.memory_lean = memory_lean;
+    discovery.dirs = get_application_dirs();
+    n_dirs = g_strv_length(discovery.dirs);
+    discovery.dir_files = g_new0(GPtrArray *, n_dirs);
+    discovery.dir_scans = g_new0(AppScan *, n_dirs);
+    
+    run_jobs(enumerate_job, &discovery, n_dirs);
+    
+    *scan = app_scan_new(discovery.dirs);
+    for (guint d = 0; d < n_dirs; d++) {
+        app_scan_append(*scan, discovery.dir_scans[d]);
+        app_scan_free(discovery.dir_scans[d]);
+    }
+    g_free(discovery.dir_scans);
+    
+    /* The first directory that has a desktop id wins, even if that file is
+     * hidden; nothing is parsed for the ids it masks */
+    discovery.winners = g_ptr_array_new_with_free_func((GDestroyNotify)desktop_file_free);
+    for (guint d = 0; d < n_dirs; d++) {
+        GPtrArray *files = discovery.dir_files[d];
         
-        dir = g_dir_open(user_flatpak_dir, 0, &error);
-        if (dir) {
-            while ((filename = g_dir_read_name(dir)) != NULL) {
-                if (g_str_has_suffix(filename, ".desktop")) {
-                    gchar *desktop_path = g_build_filename(user_flatpak_dir, filename, NULL);
-                    GDesktopAppInfo *desktop_info = g_desktop_app_info_new_from_filename(desktop_path);
-                    
-                    if (desktop_info && g_app_info_should_show(G_APP_INFO(desktop_info))) {
-                        AppInfo *app_info = g_new0(AppInfo, 1);
-                        app_info->name = g_strdup(g_app_info_get_display_name(G_APP_INFO(desktop_info)));
-                        app_info->exec = g_strdup(g_app_info_get_commandline(G_APP_INFO(desktop_info)));
-                        
-                        GIcon *gicon = g_app_info_get_icon(G_APP_INFO(desktop_info));
-                        if (gicon && G_IS_THEMED_ICON(gicon)) {
-                            const gchar * const *icon_names = g_themed_icon_get_names(G_THEMED_ICON(gicon));
-                            if (icon_names && icon_names[0])
-                                app_info->icon = g_strdup(icon_names[0]);
-                        }
-                        
-                        app_info->desktop_info = desktop_info;
-                        app_info->position = -1;
-                        *app_list = g_list_prepend(*app_list, app_info);
-                    }
-                    
-                    g_free(desktop_path);
-                }
+        for (guint i = 0; files && i < files->len; i++) {
+            DesktopFile *file = g_ptr_array_index(files, i);
+            
+            n_files++;
+            if (g_hash_table_contains(ids, file->desktop_id)) {
+                desktop_file_free(file);
+                n_masked++;
+                continue;
             }
-            g_dir_close(dir);
+            g_hash_table_add(ids, file->desktop_id);
+            g_ptr_array_add(discovery.winners, file);
+        }
+        if (files)
+            g_ptr_array_unref(files);
+    }
+    g_hash_table_destroy(ids);
+    trace_end(TRACE_DISCOVER_ENUMERATE, start);
+    
+    parse_start = trace_begin();
+    n_chunks = (discovery.winners->len + LOADER_BATCH_SIZE - 1) / LOADER_BATCH_SIZE;
+    if (!loader)
+        discovery.parsed = g_new0(GPtrArray *, n_chunks);
+    run_jobs(parse_job, &discovery, n_chunks);
+    trace_end(TRACE_DISCOVER_PARSE, parse_start);
+    
+    if (!loader) {
+        apps = app_array_new();
+        for (guint i = 0; i < n_chunks; i++) {
+            app_array_move(apps, discovery.parsed[i]);
+            g_ptr_array_unref(discovery.parsed[i]);
         }
+        g_ptr_array_sort(apps, compare_app_name_entries);
+        g_free(discovery.parsed);
     }
     
-    g_free(user_flatpak_dir);
+    g_debug("Discovery: %u directories, %u files, %u masked, %d parsed, %d shown; "
+            "enumerate %.1f ms, parse %.1f ms",
+            n_dirs, n_files, n_masked, discovery.n_parsed, discovery.n_shown,
+            (parse_start - start) / 1000.0, (g_get_monotonic_time() - parse_start) / 1000.0);
+    
+    g_ptr_array_unref(discovery.winners);
+    g_free(discovery.dir_files);
+    g_strfreev(discovery.dirs);
+    return apps;
+}
+
+/* Restore the list from the application cache, NULL if it is stale or empty */
+static GPtrArray* load_cached_applications(AppScan **scan) {
+    GPtrArray *app_list = app_cache_load(scan);
+    
+    if (app_list && app_list->len == 0) {
+        g_ptr_array_unref(app_list);
+        if (scan)
+            g_clear_pointer(scan, app_scan_free);
+        return NULL;
+    }
+    return app_list;
 }
 
 /* Enhanced load_applications function */
-GList* load_applications_enhanced(void) {
-    GList *app_list = NULL;
-    GList *apps = g_app_info_get_all();
+GPtrArray* load_applications_enhanced(gboolean memory_lean) {
+    GPtrArray *app_list;
+    AppScan *scan;
+    gint64 start = trace_begin();
+    
+    /* Warm start: reuse the on-disk index if nothing changed since it was written */
+    app_list = load_cached_applications(NULL);
+    if (app_list) {
+        trace_end(TRACE_LOAD_APPLICATIONS, start);
+        return app_list;
+    }
+    
+    app_list = discover_applications(NULL, memory_lean, &scan);
+    
+    /* Remember the result for the next panel start */
+    app_cache_save(app_list, scan);
+    app_scan_free(scan);
+    
+    trace_end(TRACE_LOAD_APPLICATIONS, start);
+    return app_list;
+}
+
+/* Worker thread: restore the cache or scan, streaming batches back */
+static void load_applications_thread(GTask *task,
+                                     gpointer source_object,
+                                     gpointer task_data,
+                                     GCancellable *cancellable) {
+    AppLoader *loader = (AppLoader *)task_data;
+    GPtrArray *app_list;
+    AppScan *scan = NULL;
+    gint64 start = trace_begin();
+    
+    app_list = load_cached_applications(&scan);
+    if (app_list) {
+        app_loader_deliver(loader, app_list, scan, TRUE, TRUE);
+        trace_end(TRACE_LOAD_APPLICATIONS, start);
+        g_task_return_boolean(task, TRUE);
+        return;
+    }
+    
+    discover_applications(loader, loader->memory_lean, &scan);
+    app_loader_deliver(loader, app_array_new(), scan, TRUE, FALSE);
+    
+    trace_end(TRACE_LOAD_APPLICATIONS, start);
+    g_task_return_boolean(task, TRUE);
+}
+
+static gboolean view_is_visible(LauncherPlugin *launcher) {
+    return launcher->overlay_window && gtk_widget_get_visible(launcher->overlay_window);
+}
+
+/* Rebuild the filtered list after the catalog changed and redraw if shown */
+static void refresh_application_view(LauncherPlugin *launcher, gboolean redraw_page) {
+    const gchar *search_text = launcher->search_entry ?
+                               gtk_entry_get_text(GTK_ENTRY(launcher->search_entry)) : NULL;
+    gboolean visible = view_is_visible(launcher);
+    
+    /* An active search re-filters and redraws by itself */
+    if (visible && search_text && *search_text && !launcher->open_folder) {
+        on_search_changed(GTK_SEARCH_ENTRY(launcher->search_entry), launcher);
+        return;
+    }
+    
+    if (!launcher->open_folder)
+        catalog_fill_view(launcher);
+    
+    if (visible) {
+        if (redraw_page)
+            populate_current_page(launcher);
+        update_page_dots(launcher);
+    }
+}
+
+/* Main loop side of the loader */
+static gboolean on_application_batch(gpointer data) {
+    AppBatch *batch = (AppBatch *)data;
+    AppLoader *loader = batch->loader;
+    Catalog *catalog = loader->catalog;
     GList *iter;
+    guint shown_before;
     
-    /* Load standard applications */
-    for (iter = apps; iter != NULL; iter = g_list_next(iter)) {
-        GAppInfo *gapp_info = G_APP_INFO(iter->data);
+    /* The catalog may be gone already */
+    if (g_cancellable_is_cancelled(loader->cancellable))
+        return G_SOURCE_REMOVE;
+    
+    /* Search results may point into the list being replaced */
+    search_index_invalidate(catalog);
+    
+    if (loader->progressive) {
+        /* The cache is stored in display order, parsed batches come sorted */
+        if (batch->from_cache)
+            g_ptr_array_sort(batch->apps, compare_app_name_entries);
         
-        if (g_app_info_should_show(gapp_info)) {
-            AppInfo *app_info = g_new0(AppInfo, 1);
-            app_info->name = g_strdup(g_app_info_get_display_name(gapp_info));
-            app_info->exec = g_strdup(g_app_info_get_commandline(gapp_info));
-            
-            GIcon *gicon = g_app_info_get_icon(gapp_info);
-            if (gicon && G_IS_THEMED_ICON(gicon)) {
-                const gchar * const *icon_names = g_themed_icon_get_names(G_THEMED_ICON(gicon));
-                if (icon_names && icon_names[0])
-                    app_info->icon = g_strdup(icon_names[0]);
+        shown_before = catalog->apps->len;
+        app_array_merge(catalog->apps, batch->apps);
+        
+        /* Only redraw views whose visible page is still filling up */
+        if (!batch->done) {
+            for (iter = catalog->views; iter != NULL; iter = g_list_next(iter)) {
+                LauncherPlugin *launcher = (LauncherPlugin *)iter->data;
+                refresh_application_view(launcher, shown_before < view_get_end_index(launcher));
             }
+            return G_SOURCE_REMOVE;
+        }
+    } else {
+        if (!loader->apps)
+            loader->apps = app_array_new();
+        app_array_move(loader->apps, batch->apps);
+        
+        /* Nothing reads the list before it is complete */
+        if (!batch->done)
+            return G_SOURCE_REMOVE;
+        g_ptr_array_sort(loader->apps, compare_app_name_entries);
+    }
+    
+    if (!loader->progressive) {
+        /* Replace the previous list; folders and views only borrow its entries */
+        for (iter = catalog->folder_list; iter != NULL; iter = g_list_next(iter)) {
+            FolderInfo *folder = (FolderInfo *)iter->data;
+            g_ptr_array_set_size(folder->apps, 0);
+        }
+        for (iter = catalog->views; iter != NULL; iter = g_list_next(iter)) {
+            LauncherPlugin *launcher = (LauncherPlugin *)iter->data;
             
-            app_info->desktop_info = G_DESKTOP_APP_INFO(g_object_ref(gapp_info));
-            app_info->position = -1;
+            if (launcher->open_folder) {
+                launcher->open_folder = NULL;
+                gtk_widget_hide(launcher->back_button);
+            }
+            launcher->drag_source = NULL;
+            g_ptr_array_set_size(launcher->filtered, 0);
+        }
+        
+        g_ptr_array_unref(catalog->apps);
+        catalog->apps = g_steal_pointer(&loader->apps);
+    }
+    
+    /* The first complete list gets the saved layout applied, which looks
+     * entries up by desktop id */
+    rebuild_application_index(catalog);
+    if (!catalog->config_loaded) {
+        load_configuration(catalog_get_primary_view(catalog));
+        catalog->config_loaded = TRUE;
+    }
+    
+    for (iter = catalog->views; iter != NULL; iter = g_list_next(iter))
+        refresh_application_view((LauncherPlugin *)iter->data, TRUE);
+    
+    /* Later refreshes keep the scan up to date for their cache writes */
+    app_scan_free(catalog->app_scan);
+    catalog->app_scan = g_steal_pointer(&batch->scan);
+    if (catalog->monitor_queue)
+        watch_scan(catalog->monitor_queue, catalog->app_scan);
+    if (!batch->from_cache)
+        app_cache_save_async(catalog->apps, catalog->app_scan);
+    icon_cache_preload(catalog_get_primary_view(catalog), catalog->apps);
+    
+    catalog->loader = NULL;
+    
+    /* Changes made while the list was incomplete were held back */
+    if (catalog->config_dirty) {
+        catalog->config_dirty = FALSE;
+        save_configuration(catalog_get_primary_view(catalog));
+    }
+    
+    app_loader_unref(loader);
+    
+    return G_SOURCE_REMOVE;
+}
+
+/* Discover applications off the main loop. The first load streams entries
+ * into the catalog as they are found; later reloads swap the list in once
+ * complete. A running load is cancelled. */
+void load_applications_async(Catalog *catalog) {
+    AppLoader *loader;
+    GTask *task;
+    
+    cancel_application_loading(catalog);
+    
+    loader = g_new0(AppLoader, 1);
+    loader->ref_count = 1;
+    loader->catalog = catalog;
+    loader->cancellable = g_cancellable_new();
+    loader->progressive = (catalog->apps->len == 0);
+    loader->memory_lean = catalog->memory_lean;
+    catalog->loader = loader;
+    
+    task = g_task_new(NULL, loader->cancellable, NULL, NULL);
+    g_task_set_task_data(task, app_loader_ref(loader), (GDestroyNotify)app_loader_unref);
+    g_task_run_in_thread(task, load_applications_thread);
+    g_object_unref(task);
+}
+
+void cancel_application_loading(Catalog *catalog) {
+    if (catalog->loader) {
+        g_cancellable_cancel(catalog->loader->cancellable);
+        app_loader_unref(catalog->loader);
+        catalog->loader = NULL;
+    }
+}
+
+void rebuild_application_index(Catalog *catalog) {
+    if (catalog->app_index)
+        g_hash_table_remove_all(catalog->app_index);
+    else
+        catalog->app_index = g_hash_table_new(g_str_hash, g_str_equal);
+    
+    for (guint i = 0; i < catalog->apps->len; i++) {
+        AppInfo *app = g_ptr_array_index(catalog->apps, i);
+        if (app->desktop_id)
+            g_hash_table_insert(catalog->app_index, (gpointer)app->desktop_id, app);
+    }
+}
+
+/* Path of the file for desktop_id below dir, NULL if there is none. Every
+ * '-' in the id may also stand for a subdirectory, see subdir_prefix(). */
+static gchar* find_desktop_file(const gchar *dir, const gchar *desktop_id, guint depth) {
+    gchar *path = g_build_filename(dir, desktop_id, NULL);
+    const gchar *dash;
+    
+    if (g_file_test(path, G_FILE_TEST_IS_REGULAR))
+        return path;
+    g_free(path);
+    
+    if (depth >= APP_DIR_MAX_DEPTH)
+        return NULL;
+    
+    for (dash = strchr(desktop_id, '-'); dash != NULL; dash = strchr(dash + 1, '-')) {
+        gchar *name = g_strndup(desktop_id, dash - desktop_id);
+        gchar *subdir = g_build_filename(dir, name, NULL);
+        
+        path = g_file_test(subdir, G_FILE_TEST_IS_DIR) ?
+               find_desktop_file(subdir, dash + 1, depth + 1) : NULL;
+        g_free(subdir);
+        g_free(name);
+        if (path)
+            return path;
+    }
+    return NULL;
+}
+
+/* Find the entry that wins for desktop_id, following directory precedence.
+ * GLib's own desktop file index may not have seen the change yet, so the
+ * directories are checked directly. */
+static GDesktopAppInfo* resolve_desktop_id(const gchar *desktop_id) {
+    gchar **dirs = get_application_dirs();
+    GDesktopAppInfo *desktop_info = NULL;
+    
+    for (int i = 0; dirs[i] != NULL; i++) {
+        gchar *path = find_desktop_file(dirs[i], desktop_id, 0);
+        
+        /* The first file masks all others, even if it is hidden or broken */
+        if (path) {
+            desktop_info = g_desktop_app_info_new_from_filename(path);
+            g_free(path);
+            break;
+        }
+    }
+    
+    g_strfreev(dirs);
+    return desktop_info;
+}
+
+/* Position of app among the tiles of the current view, -1 if not shown */
+static gint displayed_index(LauncherPlugin *launcher, AppInfo *app) {
+    gint index = launcher->open_folder ? 0 : g_list_length(launcher->catalog->folder_list);
+    guint position;
+    
+    if (!g_ptr_array_find(launcher->filtered, app, &position))
+        return -1;
+    return index + position;
+}
+
+/* Whether a change at this tile index shows up on the current page */
+static gboolean index_affects_page(LauncherPlugin *launcher, gint index) {
+    return index >= 0 && (guint)index < view_get_end_index(launcher);
+}
+
+/* Note the visible views whose current page shows app */
+static void mark_affected_views(Catalog *catalog, AppInfo *app, GHashTable *redraw) {
+    GList *iter;
+    
+    for (iter = catalog->views; iter != NULL; iter = g_list_next(iter)) {
+        LauncherPlugin *launcher = (LauncherPlugin *)iter->data;
+        
+        if (view_is_visible(launcher) &&
+            index_affects_page(launcher, displayed_index(launcher, app)))
+            g_hash_table_add(redraw, launcher);
+    }
+}
+
+/* Apply one created, changed or deleted desktop id to the catalog, keeping the
+ * hidden, folder and position state of an existing entry. Views whose
+ * visible page the change lands on are added to redraw. */
+static void update_application_entry(Catalog *catalog, const gchar *desktop_id,
+                                     GHashTable *redraw) {
+    GDesktopAppInfo *desktop_info = resolve_desktop_id(desktop_id);
+    AppInfo *app = g_hash_table_lookup(catalog->app_index, desktop_id);
+    GList *iter;
+    guint index;
+    
+    if (desktop_info && !g_app_info_should_show(G_APP_INFO(desktop_info)))
+        g_clear_object(&desktop_info);
+    
+    /* A launch must not pick up the old file */
+    catalog_forget_desktop_info(catalog, desktop_id);
+    
+    if (app)
+        mark_affected_views(catalog, app, redraw);
+    
+    if (app && desktop_info) {
+        /* Replace the parsed fields, the user's state stays on the entry */
+        AppInfo *fresh = app_info_new_from_desktop_info(desktop_info, desktop_id, catalog->memory_lean);
+        gboolean renamed = g_strcmp0(app->name, fresh->name) != 0;
+        
+        g_hash_table_remove(catalog->app_index, app->desktop_id);
+        app_info_replace_strings(app, fresh);
+        g_hash_table_insert(catalog->app_index, (gpointer)app->desktop_id, app);
+        
+        if (renamed && app->position == -1 && g_ptr_array_find(catalog->apps, app, &index)) {
+            g_ptr_array_steal_index(catalog->apps, index);
+            app_array_insert_sorted(catalog->apps, app, compare_app_positions);
+        }
+    } else if (app) {
+        /* Removed, or no longer shown */
+        g_hash_table_remove(catalog->app_index, app->desktop_id);
+        remove_app_from_folder(catalog_get_primary_view(catalog), app);
+        for (iter = catalog->views; iter != NULL; iter = g_list_next(iter)) {
+            LauncherPlugin *launcher = (LauncherPlugin *)iter->data;
             
-            app_list = g_list_prepend(app_list, app_info);
+            g_ptr_array_remove(launcher->filtered, app);
+            if (launcher->drag_source == app)
+                launcher->drag_source = NULL;
         }
+        /* Frees the entry */
+        g_ptr_array_remove(catalog->apps, app);
+        return;
+    } else if (desktop_info) {
+        app = app_info_new_from_desktop_info(desktop_info, desktop_id, catalog->memory_lean);
+        app_array_insert_sorted(catalog->apps, app, compare_app_positions);
+        g_hash_table_insert(catalog->app_index, (gpointer)app->desktop_id, app);
+    } else {
+        return;
     }
     
-    g_list_free_full(apps, g_object_unref);
+    /* The entry may also have moved onto a page */
+    for (iter = catalog->views; iter != NULL; iter = g_list_next(iter)) {
+        LauncherPlugin *launcher = (LauncherPlugin *)iter->data;
+        
+        if (view_is_visible(launcher) && !launcher->open_folder)
+            catalog_fill_view(launcher);
+    }
+    mark_affected_views(catalog, app, redraw);
+}
+
+/* Bring one view in step after entries changed */
+static void refresh_entries_view(LauncherPlugin *launcher, gboolean redraw) {
+    gboolean visible = view_is_visible(launcher);
     
-    /* Load Snap applications */
-    load_snap_applications(&app_list);
+    /* Entries may have changed in place */
+    page_cache_invalidate(launcher);
     
-    /* Load Flatpak applications */
-    load_flatpak_applications(&app_list);
+    /* The recent row may show entries that are not on the current page,
+     * and must not keep one that was removed */
+    populate_recent_row(launcher);
     
-    /* Remove duplicates based on desktop file name or app name */
-    GHashTable *seen_apps = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
-    GList *unique_list = NULL;
+    /* Keep the filtered view in step without touching the widgets */
+    if (visible && !launcher->open_folder &&
+        *gtk_entry_get_text(GTK_ENTRY(launcher->search_entry))) {
+        gint page = launcher->current_page;
+        on_search_changed(GTK_SEARCH_ENTRY(launcher->search_entry), launcher);
+        if (page != launcher->current_page && page < launcher->total_pages) {
+            launcher->current_page = page;
+            populate_current_page(launcher);
+            update_page_dots(launcher);
+        }
+        return;
+    }
     
-    for (iter = app_list; iter != NULL; iter = g_list_next(iter)) {
-        AppInfo *app = (AppInfo *)iter->data;
-        gchar *key = g_strdup(app->name);
+    if (!launcher->open_folder)
+        catalog_fill_view(launcher);
+    
+    if (!visible)
+        return;
+    
+    if (redraw)
+        populate_current_page(launcher);
+    update_page_dots(launcher);
+}
+
+/* Apply a batch of desktop ids and re-render each visible page at most once */
+void refresh_application_entries(Catalog *catalog, GList *desktop_ids) {
+    GHashTable *redraw = g_hash_table_new(NULL, NULL);
+    GList *iter;
+    
+    for (iter = desktop_ids; iter != NULL; iter = g_list_next(iter)) {
+        g_debug("Refreshing application entry %s", (const gchar *)iter->data);
+        update_application_entry(catalog, iter->data, redraw);
+    }
+    
+    search_index_invalidate(catalog);
+    
+    for (iter = catalog->views; iter != NULL; iter = g_list_next(iter))
+        refresh_entries_view(iter->data, g_hash_table_contains(redraw, iter->data));
+    
+    g_hash_table_destroy(redraw);
+}
+
+/* Coalescing of monitor events: paths are collected per directory and only
+ * applied once every directory has been quiet for the configured window */
+struct _MonitorQueue {
+    Catalog *catalog;
+    GHashTable *watches;        /* directory -> DirWatch */
+    GHashTable *pending;        /* directory -> set of desktop ids */
+    GCancellable *cancellable;  /* scans of new subdirectories */
+    guint flush_id;
+    gint64 first_event;
+    guint events_received;
+    guint refreshes_performed;
+};
+
+/* One watched directory: an applications directory or a subdirectory that
+ * discovery reads */
+typedef struct {
+    MonitorQueue *queue;
+    GFileMonitor *monitor;
+    gchar *path;
+    gchar *prefix;              /* desktop id prefix of the files in it */
+    guint depth;                /* below the applications directory */
+} DirWatch;
+
+/* Upper bound for the delay, in quiet windows, under a constant event stream */
+#define MONITOR_MAX_DELAY_WINDOWS 10
+
+static gboolean flush_monitor_events(gpointer data) {
+    MonitorQueue *queue = (MonitorQueue *)data;
+    Catalog *catalog = queue->catalog;
+    GHashTable *ids = g_hash_table_new(g_str_hash, g_str_equal);
+    GHashTableIter dir_iter;
+    gpointer dir, dir_set;
+    GList *batch;
+    
+    queue->flush_id = 0;
+    
+    /* The same id may have changed in several directories */
+    g_hash_table_iter_init(&dir_iter, queue->pending);
+    while (g_hash_table_iter_next(&dir_iter, NULL, &dir_set)) {
+        GHashTableIter id_iter;
+        gpointer id;
+    
+        g_hash_table_iter_init(&id_iter, dir_set);
+        while (g_hash_table_iter_next(&id_iter, &id, NULL))
+            g_hash_table_add(ids, id);
+    }
+    batch = g_list_sort(g_hash_table_get_keys(ids), (GCompareFunc)g_strcmp0);
+    
+    queue->refreshes_performed++;
+    g_debug("Monitor: %u events received, %u refreshes performed, %u entries in this batch",
+            queue->events_received, queue->refreshes_performed, g_list_length(batch));
+    
+    if (catalog->loader || !catalog->app_index) {
+        /* The running load may already have read these directories */
+        load_applications_async(catalog);
+    } else {
+        /* Stat the changed directories before their entries are parsed */
+        g_hash_table_iter_init(&dir_iter, queue->pending);
+        while (g_hash_table_iter_next(&dir_iter, &dir, NULL) && catalog->app_scan)
+            app_scan_restamp_dir(catalog->app_scan, dir);
         
-        if (!g_hash_table_contains(seen_apps, key)) {
-            g_hash_table_insert(seen_apps, key, app);
-            unique_list = g_list_prepend(unique_list, app);
-        } else {
-            g_free(key);
-            free_app_info(app);
+        refresh_application_entries(catalog, batch);
+        if (catalog->app_scan)
+            app_cache_save_async(catalog->apps, catalog->app_scan);
+    }
+    
+    g_list_free(batch);
+    g_hash_table_destroy(ids);
+    g_hash_table_remove_all(queue->pending);
+    
+    return G_SOURCE_REMOVE;
+}
+
+/* Note desktop_id as changed in the watched directory */
+static void queue_desktop_id(DirWatch *watch, const gchar *desktop_id) {
+    GHashTable *dir_set = g_hash_table_lookup(watch->queue->pending, watch->path);
+    
+    if (!dir_set) {
+        dir_set = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+        g_hash_table_insert(watch->queue->pending, g_strdup(watch->path), dir_set);
+    }
+    g_hash_table_add(dir_set, g_strdup(desktop_id));
+}
+
+/* Restart the quiet window, unless the batch is already overdue */
+static void schedule_flush(MonitorQueue *queue) {
+    guint quiet_ms;
+    gint64 now;
+    
+    if (g_hash_table_size(queue->pending) == 0)
+        return;
+    
+    quiet_ms = launcher_settings_get_monitor_quiet_ms(catalog_get_primary_view(queue->catalog));
+    now = g_get_monotonic_time();
+    if (queue->flush_id == 0) {
+        queue->first_event = now;
+    } else if (now - queue->first_event < (gint64)quiet_ms * 1000 * MONITOR_MAX_DELAY_WINDOWS) {
+        g_source_remove(queue->flush_id);
+    } else {
+        return;
+    }
+    queue->flush_id = g_timeout_add(quiet_ms, flush_monitor_events, queue);
+}
+
+static void watch_directory(MonitorQueue *queue, const gchar *path, const gchar *prefix,
+                            guint depth);
+
+/* Watch path, a directory discovery read below root, with the desktop id
+ * prefix and depth enumerate_dir() gave it. Returns FALSE if path is not
+ * below root. */
+static gboolean watch_below(MonitorQueue *queue, const gchar *root, const gchar *root_prefix,
+                            guint root_depth, const gchar *path) {
+    gsize root_len = strlen(root);
+    gchar **names;
+    GString *prefix;
+    guint depth = root_depth;
+    
+    if (root_len == 0 || strncmp(path, root, root_len) != 0 ||
+        (path[root_len] != '\0' && path[root_len] != G_DIR_SEPARATOR))
+        return FALSE;
+    
+    prefix = g_string_new(root_prefix);
+    names = g_strsplit(path + root_len, G_DIR_SEPARATOR_S, -1);
+    for (guint i = 0; names[i] != NULL; i++) {
+        if (*names[i] == '\0')
+            continue;
+        g_string_append(prefix, names[i]);
+        g_string_append_c(prefix, '-');
+        depth++;
+    }
+    
+    watch_directory(queue, path, prefix->str, depth);
+    g_strfreev(names);
+    g_string_free(prefix, TRUE);
+    return TRUE;
+}
+
+/* Watch the directories a load read, each with the prefix of the
+ * applications directory it was found in */
+static void watch_scan(MonitorQueue *queue, AppScan *scan) {
+    gchar **roots = app_scan_get_search_path(scan);
+    gchar **dirs = app_scan_get_dirs(scan);
+    
+    for (guint i = 0; dirs[i] != NULL; i++) {
+        for (guint r = 0; roots && roots[r] != NULL; r++) {
+            if (watch_below(queue, roots[r], "", 0, dirs[i]))
+                break;
         }
     }
+    g_strfreev(dirs);
+}
+
+/* Enumeration of a subdirectory that appeared after the load */
+typedef struct {
+    gchar *path;
+    gchar *prefix;
+    guint depth;
+    GPtrArray *files;           /* DesktopFile */
+    AppScan *scan;
+} SubdirScan;
+
+static void subdir_scan_free(SubdirScan *subdir) {
+    g_free(subdir->path);
+    g_free(subdir->prefix);
+    g_ptr_array_unref(subdir->files);
+    app_scan_free(subdir->scan);
+    g_free(subdir);
+}
+
+static void scan_subdirectory_thread(GTask *task,
+                                     gpointer source_object,
+                                     gpointer task_data,
+                                     GCancellable *cancellable) {
+    SubdirScan *subdir = (SubdirScan *)task_data;
+    Discovery discovery = { 0 };
+    
+    enumerate_dir(&discovery, subdir->path, subdir->prefix, subdir->depth,
+                  subdir->files, subdir->scan);
+    g_task_return_boolean(task, TRUE);
+}
+
+/* Watch what the subdirectory contained and queue its files as changed */
+static void on_subdirectory_scanned(GObject *source, GAsyncResult *result, gpointer data) {
+    MonitorQueue *queue = (MonitorQueue *)data;
+    SubdirScan *subdir = g_task_get_task_data(G_TASK(result));
+    gchar **dirs;
+    
+    /* The queue is gone once the scan is cancelled */
+    if (!g_task_propagate_boolean(G_TASK(result), NULL))
+        return;
+    
+    dirs = app_scan_get_dirs(subdir->scan);
+    for (guint i = 0; dirs[i] != NULL; i++)
+        watch_below(queue, subdir->path, subdir->prefix, subdir->depth, dirs[i]);
+    g_strfreev(dirs);
+    
+    for (guint i = 0; i < subdir->files->len; i++) {
+        DesktopFile *file = g_ptr_array_index(subdir->files, i);
+        gchar *parent = g_path_get_dirname(file->path);
+        DirWatch *watch = g_hash_table_lookup(queue->watches, parent);
+        
+        if (watch)
+            queue_desktop_id(watch, file->desktop_id);
+        g_free(parent);
+    }
     
-    g_list_free(app_list);
-    g_hash_table_destroy(seen_apps);
+    schedule_flush(queue);
+}
+
+/* A subdirectory appeared: watch it right away, and enumerate it and what
+ * is below it on a worker like discovery does */
+static void add_subdirectory(DirWatch *watch, const gchar *path) {
+    MonitorQueue *queue = watch->queue;
+    SubdirScan *subdir = g_new0(SubdirScan, 1);
+    gchar *name = g_path_get_basename(path);
+    GTask *task;
     
-    /* Sort applications */
-    unique_list = g_list_sort(unique_list, compare_app_names);
+    subdir->path = g_strdup(path);
+    subdir->prefix = subdir_prefix(watch->prefix, name);
+    subdir->depth = watch->depth + 1;
+    subdir->files = g_ptr_array_new_with_free_func((GDestroyNotify)desktop_file_free);
+    subdir->scan = app_scan_new(NULL);
+    g_free(name);
     
-    return unique_list;
+    watch_directory(queue, subdir->path, subdir->prefix, subdir->depth);
+    
+    task = g_task_new(NULL, queue->cancellable, on_subdirectory_scanned, queue);
+    g_task_set_task_data(task, subdir, (GDestroyNotify)subdir_scan_free);
+    g_task_run_in_thread(task, scan_subdirectory_thread);
+    g_object_unref(task);
+}
+
+/* A subdirectory went away: stop watching it and everything below, and
+ * refresh the entries that were read from it */
+static void remove_subdirectory(DirWatch *watch, const gchar *path) {
+    MonitorQueue *queue = watch->queue;
+    GPtrArray *apps = queue->catalog->apps;
+    gchar *below = g_strconcat(path, G_DIR_SEPARATOR_S, NULL);
+    GHashTableIter iter;
+    gpointer key;
+    
+    g_hash_table_iter_init(&iter, queue->watches);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        if (strcmp(key, path) == 0 || g_str_has_prefix(key, below))
+            g_hash_table_iter_remove(&iter);
+    }
+    
+    for (guint i = 0; i < apps->len; i++) {
+        AppInfo *app = g_ptr_array_index(apps, i);
+    
+        if (app->desktop_id && app->filename && g_str_has_prefix(app->filename, below))
+            queue_desktop_id(watch, app->desktop_id);
+    }
+    g_free(below);
+}
+
+static void queue_monitor_event(DirWatch *watch, GFile *file, gboolean gone) {
+    gchar *path = g_file_get_path(file);
+    
+    /* The directory's own deletion is handled by its parent */
+    if (!path || strcmp(path, watch->path) == 0) {
+        g_free(path);
+        return;
+    }
+    
+    /* Only .desktop files, which also skips package manager temp files */
+    if (g_str_has_suffix(path, ".desktop")) {
+        gchar *name = g_path_get_basename(path);
+        gchar *desktop_id = g_strconcat(watch->prefix, name, NULL);
+    
+        queue_desktop_id(watch, desktop_id);
+        g_free(desktop_id);
+        g_free(name);
+    } else if (gone) {
+        if (g_hash_table_contains(watch->queue->watches, path))
+            remove_subdirectory(watch, path);
+    } else if (watch->depth < APP_DIR_MAX_DEPTH &&
+               !g_hash_table_contains(watch->queue->watches, path) &&
+               g_file_test(path, G_FILE_TEST_IS_DIR)) {
+        add_subdirectory(watch, path);
+    }
+    g_free(path);
+    
+    schedule_flush(watch->queue);
 }
 
 /* Directory monitor callback */
@@ -274,95 +1143,110 @@ static void on_directory_changed(GFileMonitor *monitor,
                                GFile *other_file,
                                GFileMonitorEvent event_type,
                                gpointer user_data) {
-    LauncherPlugin *launcher = (LauncherPlugin *)user_data;
+    DirWatch *watch = (DirWatch *)user_data;
     
-    /* Only refresh on meaningful changes */
-    if (event_type == G_FILE_MONITOR_EVENT_CREATED ||
-        event_type == G_FILE_MONITOR_EVENT_DELETED ||
-        event_type == G_FILE_MONITOR_EVENT_CHANGED) {
-        
-        gchar *basename = g_file_get_basename(file);
-        
-        /* Only process .desktop files */
-        if (basename && g_str_has_suffix(basename, ".desktop")) {
-            g_debug("Application change detected: %s", basename);
-            
-            /* Refresh applications list */
-            if (launcher->app_list) {
-                g_list_free_full(launcher->app_list, (GDestroyNotify)free_app_info);
-            }
-            launcher->app_list = load_applications_enhanced();
-            
-            /* Update filtered list */
-            if (launcher->filtered_list) {
-                g_list_free(launcher->filtered_list);
-            }
-            launcher->filtered_list = g_list_copy(launcher->app_list);
-            
-            /* Refresh the UI if overlay is visible */
-            if (launcher->overlay_window && 
-                gtk_widget_get_visible(launcher->overlay_window)) {
-                populate_current_page(launcher);
-                update_page_dots(launcher);
-            }
-        }
-        
-        g_free(basename);
+    watch->queue->events_received++;
+    
+    switch (event_type) {
+    case G_FILE_MONITOR_EVENT_RENAMED:
+        /* Both names may be .desktop files or directories */
+        queue_monitor_event(watch, file, TRUE);
+        if (other_file)
+            queue_monitor_event(watch, other_file, FALSE);
+        break;
+    case G_FILE_MONITOR_EVENT_DELETED:
+    case G_FILE_MONITOR_EVENT_MOVED_OUT:
+        queue_monitor_event(watch, file, TRUE);
+        break;
+    case G_FILE_MONITOR_EVENT_CREATED:
+    case G_FILE_MONITOR_EVENT_CHANGED:
+    case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+    case G_FILE_MONITOR_EVENT_MOVED_IN:
+        queue_monitor_event(watch, file, FALSE);
+        break;
+    default:
+        break;
     }
 }
 
-/* Setup directory monitoring */
-void setup_application_monitoring(LauncherPlugin *launcher) {
+static void dir_watch_free(DirWatch *watch) {
+    g_file_monitor_cancel(watch->monitor);
+    g_signal_handlers_disconnect_by_data(watch->monitor, watch);
+    g_object_unref(watch->monitor);
+    g_free(watch->path);
+    g_free(watch->prefix);
+    g_free(watch);
+}
+
+/* Watch path, a directory whose files have desktop ids starting with prefix */
+static void watch_directory(MonitorQueue *queue, const gchar *path, const gchar *prefix,
+                            guint depth) {
     GFile *file;
     GFileMonitor *monitor;
     GError *error = NULL;
+    DirWatch *watch;
     
-    /* Monitor system directories */
-    for (int i = 0; desktop_dirs[i] != NULL; i++) {
-        if (g_file_test(desktop_dirs[i], G_FILE_TEST_IS_DIR)) {
-            file = g_file_new_for_path(desktop_dirs[i]);
-            monitor = g_file_monitor_directory(file, G_FILE_MONITOR_NONE, NULL, &error);
-            
-            if (monitor) {
-                g_signal_connect(monitor, "changed", 
-                               G_CALLBACK(on_directory_changed), launcher);
-                /* Keep reference to prevent garbage collection */
-                g_object_set_data_full(G_OBJECT(launcher->plugin), 
-                                     g_strdup_printf("monitor-%d", i),
-                                     monitor, g_object_unref);
-            } else if (error) {
-                g_warning("Failed to monitor %s: %s", desktop_dirs[i], error->message);
-                g_error_free(error);
-                error = NULL;
-            }
-            
-            g_object_unref(file);
-        }
+    if (g_hash_table_contains(queue->watches, path))
+        return;
+    
+    file = g_file_new_for_path(path);
+    monitor = g_file_monitor_directory(file, G_FILE_MONITOR_WATCH_MOVES, NULL, &error);
+    g_object_unref(file);
+    
+    if (!monitor) {
+        g_warning("Failed to monitor %s: %s", path, error->message);
+        g_error_free(error);
+        return;
     }
     
-    /* Monitor user directories */
-    gchar **user_dirs = get_user_desktop_dirs();
-    for (int i = 0; user_dirs[i] != NULL; i++) {
-        if (g_file_test(user_dirs[i], G_FILE_TEST_IS_DIR)) {
-            file = g_file_new_for_path(user_dirs[i]);
-            monitor = g_file_monitor_directory(file, G_FILE_MONITOR_NONE, NULL, &error);
-            
-            if (monitor) {
-                g_signal_connect(monitor, "changed", 
-                               G_CALLBACK(on_directory_changed), launcher);
-                /* Keep reference to prevent garbage collection */
-                g_object_set_data_full(G_OBJECT(launcher->plugin), 
-                                     g_strdup_printf("user-monitor-%d", i),
-                                     monitor, g_object_unref);
-            } else if (error) {
-                g_warning("Failed to monitor %s: %s", user_dirs[i], error->message);
-                g_error_free(error);
-                error = NULL;
-            }
-            
-            g_object_unref(file);
-        }
-        g_free(user_dirs[i]);
+    watch = g_new0(DirWatch, 1);
+    watch->queue = queue;
+    watch->monitor = monitor;
+    watch->path = g_strdup(path);
+    watch->prefix = g_strdup(prefix);
+    watch->depth = depth;
+    g_signal_connect(monitor, "changed", G_CALLBACK(on_directory_changed), watch);
+    g_hash_table_insert(queue->watches, watch->path, watch);
+}
+
+/* Watch every directory discovery reads. The applications directories
+ * are watched right away so no change during the first load is missed,
+ * their subdirectories once a load has read them. */
+void setup_application_monitoring(Catalog *catalog) {
+    MonitorQueue *queue = g_new0(MonitorQueue, 1);
+    gchar **dirs = get_application_dirs();
+    
+    queue->catalog = catalog;
+    queue->watches = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+                                           (GDestroyNotify)dir_watch_free);
+    queue->pending = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                           (GDestroyNotify)g_hash_table_destroy);
+    queue->cancellable = g_cancellable_new();
+    catalog->monitor_queue = queue;
+    
+    for (guint i = 0; dirs[i] != NULL; i++) {
+        if (g_file_test(dirs[i], G_FILE_TEST_IS_DIR))
+            watch_directory(queue, dirs[i], "", 0);
     }
-    g_free(user_dirs);
+    g_strfreev(dirs);
+    
+    if (catalog->app_scan)
+        watch_scan(queue, catalog->app_scan);
+}
+
+void stop_application_monitoring(Catalog *catalog) {
+    MonitorQueue *queue = catalog->monitor_queue;
+    
+    if (!queue)
+        return;
+    
+    g_hash_table_destroy(queue->watches);
+    g_cancellable_cancel(queue->cancellable);
+    g_object_unref(queue->cancellable);
+    
+    if (queue->flush_id)
+        g_source_remove(queue->flush_id);
+    g_hash_table_destroy(queue->pending);
+    g_free(queue);
+    catalog->monitor_queue = NULL;
 }
@@ -20,73 +20,359 @@
  */
 
 #include "xfce-launcher.h"
+#include <string.h>
 
-GList* load_applications(void) {
-    GList *app_list = NULL;
-    GList *apps = g_app_info_get_all();
+GPtrArray* load_applications(void) {
+    GPtrArray *apps = app_array_new();
+    GList *app_infos = g_app_info_get_all();
     GList *iter;
     
-    for (iter = apps; iter != NULL; iter = g_list_next(iter)) {
+    for (iter = app_infos; iter != NULL; iter = g_list_next(iter)) {
         GAppInfo *gapp_info = G_APP_INFO(iter->data);
         
         if (g_app_info_should_show(gapp_info)) {
-            AppInfo *app_info = g_new0(AppInfo, 1);
-            app_info->name = g_strdup(g_app_info_get_display_name(gapp_info));
-            app_info->exec = g_strdup(g_app_info_get_commandline(gapp_info));
+            const gchar *icon = NULL;
+            AppInfo *app_info;
             
             GIcon *gicon = g_app_info_get_icon(gapp_info);
             if (gicon && G_IS_THEMED_ICON(gicon)) {
                 const gchar * const *icon_names = g_themed_icon_get_names(G_THEMED_ICON(gicon));
                 if (icon_names && icon_names[0])
-                    app_info->icon = g_strdup(icon_names[0]);
+                    icon = icon_names[0];
             }
             
+            app_info = app_info_new(g_app_info_get_display_name(gapp_info),
+                                    g_app_info_get_commandline(gapp_info), icon,
+                                    NULL, NULL, NULL, NULL, NULL);
             app_info->desktop_info = G_DESKTOP_APP_INFO(g_object_ref(gapp_info));
             
-            app_list = g_list_prepend(app_list, app_info);
+            g_ptr_array_add(apps, app_info);
         }
     }
     
-    g_list_free_full(apps, g_object_unref);
+    g_list_free_full(app_infos, g_object_unref);
     
-    app_list = g_list_sort(app_list, compare_app_names);
+    g_ptr_array_sort(apps, compare_app_name_entries);
     
-    return app_list;
+    return apps;
+}
+
+/* Copy the strings of one entry into a single block; interned strings are
+ * shared by every entry and never freed */
+static gchar* pack_strings(const gchar **fields[], const gchar *values[], guint n_fields) {
+    gsize size = 0;
+    gchar *block, *next;
+    
+    for (guint i = 0; i < n_fields; i++)
+        size += values[i] ? strlen(values[i]) + 1 : 0;
+    
+    next = block = size ? g_malloc(size) : NULL;
+    for (guint i = 0; i < n_fields; i++) {
+        if (!values[i]) {
+            *fields[i] = NULL;
+            continue;
+        }
+        size = strlen(values[i]) + 1;
+        memcpy(next, values[i], size);
+        *fields[i] = next;
+        next += size;
+    }
+    
+    return block;
+}
+
+/* New entry with position -1, any string may be NULL */
+AppInfo* app_info_new(const gchar *name, const gchar *exec, const gchar *icon,
+                      const gchar *desktop_id, const gchar *filename,
+                      const gchar *generic_name, const gchar *keywords,
+                      const gchar *categories) {
+    AppInfo *app_info = g_slice_new0(AppInfo);
+    const gchar **fields[] = {
+        &app_info->name, &app_info->exec, &app_info->desktop_id, &app_info->filename,
+        &app_info->generic_name, &app_info->keywords
+    };
+    const gchar *values[] = { name, exec, desktop_id, filename, generic_name, keywords };
+    
+    app_info->strings = pack_strings(fields, values, G_N_ELEMENTS(fields));
+    app_info->icon = g_intern_string(icon);
+    app_info->categories = g_intern_string(categories);
+    app_info->position = -1;
+    
+    return app_info;
+}
+
+/* Take over the parsed strings and desktop entry of fresh, which is freed;
+ * the user's hidden, folder and position state stays on app_info */
+void app_info_replace_strings(AppInfo *app_info, AppInfo *fresh) {
+    g_free(app_info->strings);
+    if (app_info->desktop_info)
+        g_object_unref(app_info->desktop_info);
+    
+    app_info->name = fresh->name;
+    app_info->exec = fresh->exec;
+    app_info->icon = fresh->icon;
+    app_info->desktop_id = fresh->desktop_id;
+    app_info->filename = fresh->filename;
+    app_info->generic_name = fresh->generic_name;
+    app_info->keywords = fresh->keywords;
+    app_info->categories = fresh->categories;
+    app_info->strings = g_steal_pointer(&fresh->strings);
+    app_info->desktop_info = g_steal_pointer(&fresh->desktop_info);
+    
+    free_app_info(fresh);
 }
 
 void free_app_info(AppInfo *app_info) {
     if (app_info) {
-        g_free(app_info->name);
-        g_free(app_info->exec);
-        g_free(app_info->icon);
+        g_free(app_info->strings);
         g_free(app_info->folder_id);
         if (app_info->desktop_info)
             g_object_unref(app_info->desktop_info);
-        g_free(app_info);
+        g_slice_free(AppInfo, app_info);
     }
 }
 
-void launch_application(GtkWidget *button, AppInfo *app_info) {
+/* Array that owns its entries */
+GPtrArray* app_array_new(void) {
+    return g_ptr_array_new_with_free_func((GDestroyNotify)free_app_info);
+}
+
+/* Binary search for the insertion point, after equal entries */
+void app_array_insert_sorted(GPtrArray *apps, AppInfo *app_info, GCompareFunc compare) {
+    guint low = 0, high = apps->len;
+    
+    while (low < high) {
+        guint mid = low + (high - low) / 2;
+        
+        if (compare(g_ptr_array_index(apps, mid), app_info) <= 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    g_ptr_array_insert(apps, low, app_info);
+}
+
+/* Desktop entry of app_info, a new reference. Entries restored from the
+ * application cache or built in memory-lean mode carry none; the desktop
+ * file is parsed again and kept with the catalog's recently used ones. */
+GDesktopAppInfo* app_info_get_desktop_info(Catalog *catalog, AppInfo *app_info) {
+    GDesktopAppInfo *desktop_info;
+    
+    if (!app_info)
+        return NULL;
+    
+    if (app_info->desktop_info)
+        return g_object_ref(app_info->desktop_info);
+    
+    desktop_info = catalog_lookup_desktop_info(catalog, app_info->desktop_id, app_info->filename);
+    if (desktop_info)
+        return desktop_info;
+    
+    /* Prefer the id, Snap and Flatpak entries outside XDG_DATA_DIRS can
+     * only be found by filename */
+    if (app_info->desktop_id)
+        desktop_info = g_desktop_app_info_new(app_info->desktop_id);
+    if (!desktop_info && app_info->filename)
+        desktop_info = g_desktop_app_info_new_from_filename(app_info->filename);
+    if (desktop_info)
+        catalog_remember_desktop_info(catalog, desktop_info);
+    
+    return desktop_info;
+}
+
+/* A launch in flight. The overlay is already hidden; the desktop file is
+ * parsed and the program looked up on a worker thread, the launch itself
+ * goes through g_app_info_launch_uris_async() on the main loop. */
+typedef struct {
+    LauncherPlugin *launcher;
+    GCancellable *cancellable;      /* cancelled when the plugin goes away */
+    GAppLaunchContext *context;
+    GDesktopAppInfo *desktop_info;
+    gboolean remember;              /* parsed for this launch, see catalog_remember_desktop_info() */
+    gchar *desktop_id;
+    gchar *filename;
+    gchar *name;
+} LaunchRequest;
+
+static void launch_request_free(LaunchRequest *request) {
+    g_object_unref(request->cancellable);
+    g_object_unref(request->context);
+    g_clear_object(&request->desktop_info);
+    g_free(request->desktop_id);
+    g_free(request->filename);
+    g_free(request->name);
+    g_slice_free(LaunchRequest, request);
+}
+
+static void on_notification_bus(GObject *source, GAsyncResult *result, gpointer data) {
+    GVariant *parameters = data;
+    GDBusConnection *bus = g_bus_get_finish(result, NULL);
+    
+    if (bus) {
+        g_dbus_connection_call(bus, "org.freedesktop.Notifications",
+                               "/org/freedesktop/Notifications",
+                               "org.freedesktop.Notifications", "Notify",
+                               parameters, NULL, G_DBUS_CALL_FLAGS_NONE, -1, NULL, NULL, NULL);
+        g_object_unref(bus);
+    }
+    g_variant_unref(parameters);
+}
+
+/* Report a failed launch through the notification daemon, the overlay is
+ * long gone by the time it is known. The session bus is looked up
+ * asynchronously, a missing or slow bus must not stall the panel. */
+static void notify_launch_failure(const gchar *name, const gchar *message) {
+    gchar *summary = g_strdup_printf("Failed to launch %s", name ? name : "application");
+    GVariant *parameters = g_variant_new("(susssasa{sv}i)", "Launcher", 0u,
+                                         "dialog-error", summary, message,
+                                         NULL, NULL, -1);
+    
+    g_warning("%s: %s", summary, message);
+    g_bus_get(G_BUS_TYPE_SESSION, NULL, on_notification_bus, g_variant_ref_sink(parameters));
+    g_free(summary);
+}
+
+static void on_launch_finished(GObject *source, GAsyncResult *result, gpointer data) {
+    LaunchRequest *request = data;
     GError *error = NULL;
+    
+    if (!g_app_info_launch_uris_finish(G_APP_INFO(source), result, &error)) {
+        if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+            notify_launch_failure(request->name, error->message);
+        g_error_free(error);
+    } else if (!g_cancellable_is_cancelled(request->cancellable)) {
+        launch_history_record(request->launcher, request->desktop_id);
+    }
+    
+    launch_request_free(request);
+}
+
+/* Worker: everything that may touch a slow filesystem before the launch */
+static void resolve_launch_thread(GTask *task, gpointer source, gpointer data,
+                                  GCancellable *cancellable) {
+    LaunchRequest *request = data;
+    GDesktopAppInfo *desktop_info = request->desktop_info ?
+                                    g_object_ref(request->desktop_info) : NULL;
+    const gchar *executable;
+    gchar *program;
+    
+    if (!desktop_info && request->desktop_id)
+        desktop_info = g_desktop_app_info_new(request->desktop_id);
+    if (!desktop_info && request->filename)
+        desktop_info = g_desktop_app_info_new_from_filename(request->filename);
+    if (!desktop_info) {
+        g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+                                "The desktop file could not be read");
+        return;
+    }
+    
+    /* D-Bus activated applications have no program to look up */
+    if (!g_desktop_app_info_get_boolean(desktop_info, "DBusActivatable")) {
+        executable = g_app_info_get_executable(G_APP_INFO(desktop_info));
+        program = executable ? g_find_program_in_path(executable) : NULL;
+        if (!program) {
+            g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+                                    "Program \"%s\" was not found", executable ? executable : "");
+            g_object_unref(desktop_info);
+            return;
+        }
+        g_free(program);
+    }
+    
+    g_task_return_pointer(task, desktop_info, g_object_unref);
+}
+
+static void on_launch_resolved(GObject *source, GAsyncResult *result, gpointer data) {
+    LaunchRequest *request = data;
+    GError *error = NULL;
+    GDesktopAppInfo *desktop_info = g_task_propagate_pointer(G_TASK(result), &error);
+    
+    if (!desktop_info) {
+        if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+            notify_launch_failure(request->name, error->message);
+        g_error_free(error);
+        launch_request_free(request);
+        return;
+    }
+    
+    g_clear_object(&request->desktop_info);
+    request->desktop_info = desktop_info;
+    if (request->remember && !g_cancellable_is_cancelled(request->cancellable))
+        catalog_remember_desktop_info(request->launcher->catalog, desktop_info);
+    g_app_info_launch_uris_async(G_APP_INFO(desktop_info), NULL, request->context,
+                                 request->cancellable, on_launch_finished, request);
+}
+
+void launch_application(GtkWidget *button, AppInfo *app_info) {
     GtkWidget *toplevel = gtk_widget_get_toplevel(button);
     LauncherPlugin *launcher = g_object_get_data(G_OBJECT(toplevel), "launcher");
+    GdkAppLaunchContext *context;
+    LaunchRequest *request;
+    GTask *task;
+    gint64 start = trace_begin();
     
-    if (app_info && app_info->desktop_info) {
-        g_app_info_launch(G_APP_INFO(app_info->desktop_info), NULL, NULL, &error);
-        if (error) {
-            g_warning("Failed to launch application: %s", error->message);
-            g_error_free(error);
-        } else if (launcher) {
-            hide_overlay(launcher);
-        }
+    if (!launcher)
+        return;
+    
+    /* Startup notification: the id is taken from this context */
+    context = gdk_display_get_app_launch_context(gtk_widget_get_display(button));
+    gdk_app_launch_context_set_timestamp(context, gtk_get_current_event_time());
+    
+    if (!launcher->launch_cancellable)
+        launcher->launch_cancellable = g_cancellable_new();
+    
+    request = g_slice_new0(LaunchRequest);
+    request->launcher = launcher;
+    request->cancellable = g_object_ref(launcher->launch_cancellable);
+    request->context = G_APP_LAUNCH_CONTEXT(context);
+    request->desktop_id = g_strdup(app_info->desktop_id);
+    request->filename = g_strdup(app_info->filename);
+    request->name = g_strdup(app_info->name);
+    if (app_info->desktop_info)
+        request->desktop_info = g_object_ref(app_info->desktop_info);
+    else
+        request->desktop_info = catalog_lookup_desktop_info(launcher->catalog,
+                                                            app_info->desktop_id,
+                                                            app_info->filename);
+    request->remember = !app_info->desktop_info;
+    
+    prewarm_watch_launch(launcher, app_info, request->context);
+    hide_overlay(launcher);
+    
+    task = g_task_new(NULL, request->cancellable, on_launch_resolved, request);
+    g_task_set_task_data(task, request, NULL);
+    g_task_run_in_thread(task, resolve_launch_thread);
+    g_object_unref(task);
+    trace_end(TRACE_LAUNCH, start);
+}
+
+/* Program of the command line, skipping "env VAR=value" prefixes */
+gchar* app_info_get_program(const AppInfo *app_info) {
+    gchar **argv = NULL;
+    gchar *program = NULL;
+    
+    if (!app_info->exec || !g_shell_parse_argv(app_info->exec, NULL, &argv, NULL))
+        return NULL;
+    
+    for (gint i = 0; argv[i] != NULL; i++) {
+        if (strcmp(argv[i], "env") == 0 || strchr(argv[i], '='))
+            continue;
+        program = g_strdup(argv[i]);
+        break;
     }
+    
+    g_strfreev(argv);
+    return program;
 }
 
 void hide_application(AppInfo *app_info, LauncherPlugin *launcher) {
     app_info->is_hidden = TRUE;
+    g_ptr_array_remove(launcher->filtered, app_info);
+    search_index_invalidate(launcher->catalog);
     populate_current_page(launcher);
     update_page_dots(launcher);
-    save_configuration(launcher);
+    config_record_hide(launcher, app_info);
+    catalog_refresh_views(launcher->catalog, launcher);
 }
 
 gint compare_app_names(gconstpointer a, gconstpointer b) {
@@ -99,11 +385,30 @@ gint compare_app_names(gconstpointer a, gconstpointer b) {
     return g_utf8_collate(app_a->name, app_b->name);
 }
 
+/* Display order: explicitly placed entries first, the rest by name */
+gint compare_app_positions(gconstpointer a, gconstpointer b) {
+    const AppInfo *app_a = (const AppInfo *)a;
+    const AppInfo *app_b = (const AppInfo *)b;
+    
+    if (app_a->position == -1 && app_b->position == -1)
+        return compare_app_names(a, b);
+    if (app_a->position == -1) return 1;
+    if (app_b->position == -1) return -1;
+    return app_a->position - app_b->position;
+}
+
+/* For g_ptr_array_sort(), which passes pointers to the elements */
+gint compare_app_name_entries(gconstpointer a, gconstpointer b) {
+    return compare_app_names(*(AppInfo * const *)a, *(AppInfo * const *)b);
+}
+
+gint compare_app_position_entries(gconstpointer a, gconstpointer b) {
+    return compare_app_positions(*(AppInfo * const *)a, *(AppInfo * const *)b);
+}
+
 void recalculate_positions(LauncherPlugin *launcher) {
-    GList *iter;
-    gint i = 0;
-    for (iter = launcher->app_list; iter != NULL; iter = g_list_next(iter)) {
-        AppInfo *app = (AppInfo *)iter->data;
-        app->position = i++;
-    }
+    GPtrArray *apps = launcher->catalog->apps;
+    
+    for (guint i = 0; i < apps->len; i++)
+        ((AppInfo *)g_ptr_array_index(apps, i))->position = i;
 }
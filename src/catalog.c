@@ -0,0 +1,217 @@
+/*
+ * XFCE Launcher Plugin v0.7
+ *
+ * Changelog:
+ * - Hotkey setting to toggle the launcher (integrates with XFCE custom keyboard shortcuts)
+ * - Drag & drop improvements: reorder apps, create folders, add apps to folders
+ * - Search result highlighting (matched text in app names is highlighted)
+ * - Responsive layout: grid size, icon size, and spacing adapt to the current screen resolution
+ * - Settings dialog updated (includes hotkey configuration)
+ * - Configuration saving is more robust (XML attribute escaping)
+ * - Fixed broken drag-and-drop behavior
+ * - Fixed potential memory leak when loading configuration (folder id replacement)
+ * - Fixed callback type mismatches and reduced build warnings
+
+ * Shared application catalog
+ *
+ * The panel loads internal plugins into its own process, so several
+ * launcher buttons end up side by side in one address space. They all
+ * show the same applications, so discovery, directory monitoring, the
+ * icon cache, the search index, the launch history and the folder
+ * layout live in one reference counted Catalog. Each LauncherPlugin is a
+ * view on it that only keeps UI state: the overlay, its tiles, the
+ * filtered list, the open folder and the current page. The first
+ * instance creates the catalog, the last one to go frees it.
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include "settings.h"
+
+/* Desktop entries re-parsed for launches kept in memory-lean mode */
+#define RECENT_DESKTOP_INFO_MAX 8
+
+/* Only touched from the main thread */
+static Catalog *default_catalog = NULL;
+
+static void catalog_free(Catalog *catalog) {
+    /* Drop batches still queued by the loader and pending monitor events */
+    cancel_application_loading(catalog);
+    stop_application_monitoring(catalog);
+    prewarm_free(catalog);
+    config_store_free(catalog);
+    
+    /* The views and their tiles are gone, they held their own icon references */
+    icon_cache_free(catalog);
+    
+    g_ptr_array_unref(catalog->apps);
+    if (catalog->app_index)
+        g_hash_table_destroy(catalog->app_index);
+    app_scan_free(catalog->app_scan);
+    search_index_free(catalog->search_index);
+    launch_history_free(catalog);
+    g_list_free_full(catalog->folder_list, (GDestroyNotify)free_folder_info);
+    g_queue_free_full(catalog->recent_desktop_info, g_object_unref);
+    if (catalog->geometries)
+        g_hash_table_destroy(catalog->geometries);
+    
+    g_slice_free(Catalog, catalog);
+}
+
+/* Make launcher a view of the process wide catalog, creating it if needed */
+void catalog_attach(LauncherPlugin *launcher) {
+    if (!default_catalog) {
+        default_catalog = g_slice_new0(Catalog);
+        default_catalog->apps = app_array_new();
+        default_catalog->recent_desktop_info = g_queue_new();
+    }
+    
+    default_catalog->ref_count++;
+    default_catalog->views = g_list_append(default_catalog->views, launcher);
+    launcher->catalog = default_catalog;
+    
+    /* Another instance may have loaded the applications already */
+    launcher->filtered = g_ptr_array_new();
+    catalog_fill_view(launcher);
+    
+    g_debug("Catalog: %d views", default_catalog->ref_count);
+}
+
+/* Called once the view's widgets are destroyed */
+void catalog_detach(LauncherPlugin *launcher) {
+    Catalog *catalog = launcher->catalog;
+    
+    if (!catalog)
+        return;
+    
+    catalog->views = g_list_remove(catalog->views, launcher);
+    launcher->catalog = NULL;
+    
+    if (--catalog->ref_count > 0)
+        return;
+    
+    catalog_free(catalog);
+    if (catalog == default_catalog)
+        default_catalog = NULL;
+}
+
+/* Load applications in the background and start watching for changes,
+ * the configuration is applied once the list is complete. Safe to call
+ * more than once, from any view. */
+void catalog_start_services(Catalog *catalog) {
+    if (catalog->services_started)
+        return;
+    catalog->services_started = TRUE;
+    catalog->memory_lean = launcher_settings_get_memory_lean(catalog_get_primary_view(catalog));
+    
+    icon_cache_new(catalog);
+    launch_history_load(catalog);
+    prewarm_new(catalog);
+    load_applications_async(catalog);
+    
+    /* Setup application monitoring for automatic refresh */
+    setup_application_monitoring(catalog);
+}
+
+/* The oldest view, whose settings apply to shared work such as the
+ * monitor quiet window. Never NULL while the catalog is alive. */
+LauncherPlugin* catalog_get_primary_view(Catalog *catalog) {
+    return catalog->views ? (LauncherPlugin *)catalog->views->data : NULL;
+}
+
+/* List every shown application in the view, as outside of a search or
+ * folder. Hidden and filed entries are left out, so a page is a plain
+ * slice of the array. */
+void catalog_fill_view(LauncherPlugin *launcher) {
+    GPtrArray *apps = launcher->catalog->apps;
+    
+    g_ptr_array_set_size(launcher->filtered, 0);
+    for (guint i = 0; i < apps->len; i++) {
+        AppInfo *app = g_ptr_array_index(apps, i);
+        
+        if (app_is_listed(launcher, app))
+            g_ptr_array_add(launcher->filtered, app);
+    }
+}
+
+/* Bring the other views in step after one of them changed the shared
+ * layout: hid an application, reordered it or put it into a folder */
+void catalog_refresh_views(Catalog *catalog, LauncherPlugin *except) {
+    GList *iter;
+    
+    for (iter = catalog->views; iter != NULL; iter = g_list_next(iter)) {
+        LauncherPlugin *launcher = (LauncherPlugin *)iter->data;
+        
+        if (launcher == except)
+            continue;
+        
+        page_cache_invalidate(launcher);
+        if (!launcher->open_folder)
+            catalog_fill_view(launcher);
+        if (launcher->overlay_window && gtk_widget_get_visible(launcher->overlay_window)) {
+            populate_current_page(launcher);
+            update_page_dots(launcher);
+        }
+    }
+}
+
+static gboolean desktop_info_matches(GDesktopAppInfo *desktop_info, const gchar *desktop_id,
+                                     const gchar *filename) {
+    const gchar *path = g_desktop_app_info_get_filename(desktop_info);
+    
+    if (filename && g_strcmp0(path, filename) == 0)
+        return TRUE;
+    return desktop_id && g_strcmp0(g_app_info_get_id(G_APP_INFO(desktop_info)), desktop_id) == 0;
+}
+
+/* A recently parsed desktop entry, a new reference, or NULL */
+GDesktopAppInfo* catalog_lookup_desktop_info(Catalog *catalog, const gchar *desktop_id,
+                                             const gchar *filename) {
+    GList *link;
+    
+    for (link = catalog->recent_desktop_info->head; link != NULL; link = link->next) {
+        if (desktop_info_matches(link->data, desktop_id, filename)) {
+            g_queue_unlink(catalog->recent_desktop_info, link);
+            g_queue_push_head_link(catalog->recent_desktop_info, link);
+            return g_object_ref(link->data);
+        }
+    }
+    
+    return NULL;
+}
+
+/* Keep a reference to desktop_info, dropping the least recently used */
+void catalog_remember_desktop_info(Catalog *catalog, GDesktopAppInfo *desktop_info) {
+    GQueue *recent = catalog->recent_desktop_info;
+    
+    if (g_queue_remove(recent, desktop_info))
+        g_object_unref(desktop_info);
+    g_queue_push_head(recent, g_object_ref(desktop_info));
+    
+    while (recent->length > RECENT_DESKTOP_INFO_MAX)
+        g_object_unref(g_queue_pop_tail(recent));
+}
+
+/* The desktop file changed or went away */
+void catalog_forget_desktop_info(Catalog *catalog, const gchar *desktop_id) {
+    GList *link = catalog->recent_desktop_info->head;
+    
+    while (link != NULL) {
+        GList *next = link->next;
+        GDesktopAppInfo *desktop_info = link->data;
+        const gchar *filename = g_desktop_app_info_get_filename(desktop_info);
+        gchar *basename = filename ? g_path_get_basename(filename) : NULL;
+        
+        /* Entries loaded by filename go by their basename */
+        if (desktop_info_matches(desktop_info, desktop_id, NULL) ||
+            g_strcmp0(basename, desktop_id) == 0) {
+            g_queue_delete_link(catalog->recent_desktop_info, link);
+            g_object_unref(desktop_info);
+        }
+        g_free(basename);
+        link = next;
+    }
+}
@@ -0,0 +1,316 @@
+/*
+ * XFCE Launcher Plugin v0.7
+ *
+ * Changelog:
+ * - Hotkey setting to toggle the launcher (integrates with XFCE custom keyboard shortcuts)
+ * - Drag & drop improvements: reorder apps, create folders, add apps to folders
+ * - Search result highlighting (matched text in app names is highlighted)
+ * - Responsive layout: grid size, icon size, and spacing adapt to the current screen resolution
+ * - Settings dialog updated (includes hotkey configuration)
+ * - Configuration saving is more robust (XML attribute escaping)
+ * - Fixed broken drag-and-drop behavior
+ * - Fixed potential memory leak when loading configuration (folder id replacement)
+ * - Fixed callback type mismatches and reduced build warnings
+
+ * Binary layout snapshot
+ *
+ * Next to config.xml the layout is kept in layout.bin, a file that is
+ * used in place through mmap: a header, one fixed-width record per
+ * folder and per application with saved state, and a string table.
+ * Application records are stored in display order. Compaction writes
+ * both files from the same layout; config.xml stays the portable copy
+ * and is imported instead whenever it is newer than layout.bin, for
+ * example after being edited or copied from another machine.
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <glib/gstdio.h>
+#include <string.h>
+
+#define LAYOUT_MAGIC      0x4c594c58  /* "XLYL" */
+#define LAYOUT_VERSION    1
+#define LAYOUT_NO_STRING  G_MAXUINT32
+#define LAYOUT_HIDDEN     (1 << 0)
+
+/* On-disk layout: header, folder records, app records, string table.
+ * String references are offsets into the string table. */
+typedef struct {
+    guint32 magic;
+    guint32 version;
+    guint32 generation;         /* see config-store.c */
+    guint32 n_folders;
+    guint32 n_apps;
+    guint32 strings_offset;
+    guint32 strings_size;
+    guint32 padding;
+} LayoutHeader;
+
+typedef struct {
+    guint32 id;
+    guint32 name;
+    guint32 icon;
+} LayoutFolder;
+
+typedef struct {
+    guint32 desktop_id;
+    guint32 name;               /* for files read by name, and the XML export */
+    guint32 folder;
+    gint32  position;
+    guint32 flags;
+} LayoutApp;
+
+/* A validated layout, pointing into the file or buffer it was read from */
+typedef struct {
+    const LayoutHeader *header;
+    const LayoutFolder *folders;
+    const LayoutApp *apps;
+    const gchar *strings;
+} Layout;
+
+gchar* config_layout_get_path(void) {
+    return g_build_filename(g_get_user_config_dir(), "xfce4", "launcher", "layout.bin", NULL);
+}
+
+static guint32 add_string(GByteArray *strings, GHashTable *offsets, const gchar *str) {
+    gpointer offset;
+    guint32 new_offset;
+
+    if (!str)
+        return LAYOUT_NO_STRING;
+
+    if (g_hash_table_lookup_extended(offsets, str, NULL, &offset))
+        return GPOINTER_TO_UINT(offset);
+
+    new_offset = strings->len;
+    g_byte_array_append(strings, (const guint8 *)str, strlen(str) + 1);
+    g_hash_table_insert(offsets, (gpointer)str, GUINT_TO_POINTER(new_offset));
+
+    return new_offset;
+}
+
+/* The whole layout of catalog as layout.bin contents */
+GByteArray* config_layout_build(Catalog *catalog, guint generation) {
+    LayoutHeader header = { 0 };
+    GArray *folders = g_array_new(FALSE, FALSE, sizeof(LayoutFolder));
+    GArray *apps = g_array_new(FALSE, FALSE, sizeof(LayoutApp));
+    GByteArray *strings = g_byte_array_new();
+    GHashTable *offsets = g_hash_table_new(g_str_hash, g_str_equal);
+    GByteArray *data;
+    GList *iter;
+
+    for (iter = catalog->folder_list; iter != NULL; iter = g_list_next(iter)) {
+        FolderInfo *folder = (FolderInfo *)iter->data;
+        LayoutFolder record;
+
+        record.id = add_string(strings, offsets, folder->id);
+        record.name = add_string(strings, offsets, folder->name);
+        record.icon = add_string(strings, offsets, folder->icon);
+        g_array_append_val(folders, record);
+    }
+
+    for (guint i = 0; i < catalog->apps->len; i++) {
+        AppInfo *app = g_ptr_array_index(catalog->apps, i);
+        LayoutApp record;
+
+        if (!app->is_hidden && !app->folder_id && app->position == -1)
+            continue;
+
+        record.desktop_id = add_string(strings, offsets, app->desktop_id);
+        record.name = add_string(strings, offsets, app->name);
+        record.folder = add_string(strings, offsets, app->folder_id);
+        record.position = app->position;
+        record.flags = app->is_hidden ? LAYOUT_HIDDEN : 0;
+        g_array_append_val(apps, record);
+    }
+
+    /* Never empty, so the last byte of a valid file is always a NUL */
+    if (strings->len == 0)
+        g_byte_array_append(strings, (const guint8 *)"", 1);
+
+    header.magic = LAYOUT_MAGIC;
+    header.version = LAYOUT_VERSION;
+    header.generation = generation;
+    header.n_folders = folders->len;
+    header.n_apps = apps->len;
+    header.strings_offset = sizeof(LayoutHeader) +
+                            folders->len * sizeof(LayoutFolder) +
+                            apps->len * sizeof(LayoutApp);
+    header.strings_size = strings->len;
+
+    data = g_byte_array_sized_new(header.strings_offset + header.strings_size);
+    g_byte_array_append(data, (const guint8 *)&header, sizeof(LayoutHeader));
+    g_byte_array_append(data, (const guint8 *)folders->data, folders->len * sizeof(LayoutFolder));
+    g_byte_array_append(data, (const guint8 *)apps->data, apps->len * sizeof(LayoutApp));
+    g_byte_array_append(data, strings->data, strings->len);
+
+    g_hash_table_destroy(offsets);
+    g_byte_array_free(strings, TRUE);
+    g_array_free(apps, TRUE);
+    g_array_free(folders, TRUE);
+    return data;
+}
+
+static gboolean layout_open(Layout *layout, const gchar *contents, gsize length) {
+    const LayoutHeader *header = (const LayoutHeader *)contents;
+    gsize records_size;
+
+    if (length < sizeof(LayoutHeader) ||
+        header->magic != LAYOUT_MAGIC || header->version != LAYOUT_VERSION)
+        return FALSE;
+
+    records_size = sizeof(LayoutHeader) +
+                   (gsize)header->n_folders * sizeof(LayoutFolder) +
+                   (gsize)header->n_apps * sizeof(LayoutApp);
+    if (header->strings_offset != records_size ||
+        (gsize)header->strings_offset + header->strings_size != length ||
+        header->strings_size == 0 ||
+        contents[length - 1] != '\0')
+        return FALSE;
+
+    layout->header = header;
+    layout->folders = (const LayoutFolder *)(contents + sizeof(LayoutHeader));
+    layout->apps = (const LayoutApp *)(layout->folders + header->n_folders);
+    layout->strings = contents + header->strings_offset;
+    return TRUE;
+}
+
+static const gchar* layout_string(const Layout *layout, guint32 offset) {
+    if (offset == LAYOUT_NO_STRING || offset >= layout->header->strings_size)
+        return NULL;
+    return layout->strings + offset;
+}
+
+static void append_escaped(GString *xml, const gchar *format, ...) {
+    va_list args;
+    gchar *text;
+
+    va_start(args, format);
+    text = g_markup_vprintf_escaped(format, args);
+    va_end(args);
+    g_string_append(xml, text);
+    g_free(text);
+}
+
+/* config.xml contents for a layout built by config_layout_build(), safe
+ * to call from any thread */
+gchar* config_layout_to_xml(const GByteArray *data) {
+    Layout layout;
+    GString *xml;
+
+    if (!layout_open(&layout, (const gchar *)data->data, data->len))
+        return NULL;
+
+    xml = g_string_new("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    g_string_append_printf(xml, "<launcher-config generation=\"%u\">\n", layout.header->generation);
+
+    g_string_append(xml, "  <folders>\n");
+    for (guint32 i = 0; i < layout.header->n_folders; i++) {
+        const LayoutFolder *folder = &layout.folders[i];
+
+        append_escaped(xml, "    <folder id=\"%s\" name=\"%s\" icon=\"%s\"/>\n",
+                       layout_string(&layout, folder->id),
+                       layout_string(&layout, folder->name),
+                       layout_string(&layout, folder->icon));
+    }
+    g_string_append(xml, "  </folders>\n");
+
+    g_string_append(xml, "  <apps>\n");
+    for (guint32 i = 0; i < layout.header->n_apps; i++) {
+        const LayoutApp *app = &layout.apps[i];
+        const gchar *desktop_id = layout_string(&layout, app->desktop_id);
+        const gchar *folder = layout_string(&layout, app->folder);
+
+        g_string_append(xml, "    <app");
+        if (desktop_id)
+            append_escaped(xml, " id=\"%s\"", desktop_id);
+        append_escaped(xml, " name=\"%s\" hidden=\"%s\" position=\"%d\"",
+                       layout_string(&layout, app->name),
+                       (app->flags & LAYOUT_HIDDEN) ? "true" : "false", app->position);
+        if (folder)
+            append_escaped(xml, " folder=\"%s\"", folder);
+        g_string_append(xml, "/>\n");
+    }
+    g_string_append(xml, "  </apps>\n");
+    g_string_append(xml, "</launcher-config>\n");
+
+    return g_string_free(xml, FALSE);
+}
+
+static gint64 stat_mtime(const gchar *path) {
+    GStatBuf st;
+
+    if (g_stat(path, &st) != 0)
+        return -1;
+    return (gint64)st.st_mtim.tv_sec * G_GINT64_CONSTANT(1000000000) + st.st_mtim.tv_nsec;
+}
+
+/* Apply layout.bin if it exists, is valid and is not older than
+ * config.xml. Returns FALSE if config.xml should be imported instead. */
+gboolean config_layout_load(LauncherPlugin *launcher, guint *generation) {
+    Catalog *catalog = launcher->catalog;
+    gchar *layout_path = config_layout_get_path();
+    gchar *config_path = get_config_file_path();
+    gint64 layout_mtime = stat_mtime(layout_path);
+    gint64 config_mtime = stat_mtime(config_path);
+    GMappedFile *mapped = NULL;
+    GHashTable *by_name = NULL;
+    Layout layout;
+
+    if (layout_mtime >= 0 && layout_mtime >= config_mtime)
+        mapped = g_mapped_file_new(layout_path, FALSE, NULL);
+    g_free(config_path);
+    g_free(layout_path);
+    if (!mapped)
+        return FALSE;
+
+    if (!layout_open(&layout, g_mapped_file_get_contents(mapped), g_mapped_file_get_length(mapped))) {
+        g_debug("Layout file is invalid, importing config.xml");
+        g_mapped_file_unref(mapped);
+        return FALSE;
+    }
+
+    for (guint32 i = 0; i < layout.header->n_folders; i++) {
+        const gchar *id = layout_string(&layout, layout.folders[i].id);
+        const gchar *name = layout_string(&layout, layout.folders[i].name);
+        const gchar *icon = layout_string(&layout, layout.folders[i].icon);
+        FolderInfo *folder;
+
+        if (!id || !name)
+            continue;
+
+        folder = create_folder(name);
+        g_free(folder->id);
+        folder->id = g_strdup(id);
+        if (icon) {
+            g_free(folder->icon);
+            folder->icon = g_strdup(icon);
+        }
+        catalog->folder_list = g_list_append(catalog->folder_list, folder);
+    }
+
+    for (guint32 i = 0; i < layout.header->n_apps; i++) {
+        const LayoutApp *record = &layout.apps[i];
+        const gchar *folder = layout_string(&layout, record->folder);
+        AppInfo *app = config_find_app(catalog, &by_name,
+                                       layout_string(&layout, record->desktop_id),
+                                       layout_string(&layout, record->name));
+
+        if (!app)
+            continue;
+        if (record->flags & LAYOUT_HIDDEN)
+            app->is_hidden = TRUE;
+        if (folder)
+            add_app_to_folder(launcher, app, folder);
+        app->position = record->position;
+    }
+
+    *generation = layout.header->generation;
+    if (by_name)
+        g_hash_table_destroy(by_name);
+    g_mapped_file_unref(mapped);
+    return TRUE;
+}
@@ -0,0 +1,389 @@
+/*
+ * XFCE Launcher Plugin v0.7
+ *
+ * Changelog:
+ * - Hotkey setting to toggle the launcher (integrates with XFCE custom keyboard shortcuts)
+ * - Drag & drop improvements: reorder apps, create folders, add apps to folders
+ * - Search result highlighting (matched text in app names is highlighted)
+ * - Responsive layout: grid size, icon size, and spacing adapt to the current screen resolution
+ * - Settings dialog updated (includes hotkey configuration)
+ * - Configuration saving is more robust (XML attribute escaping)
+ * - Fixed broken drag-and-drop behavior
+ * - Fixed potential memory leak when loading configuration (folder id replacement)
+ * - Fixed callback type mismatches and reduced build warnings
+
+ * Journaled configuration store
+ *
+ * layout.bin and config.xml are snapshots of the layout, see
+ * config-layout.c. Hiding, moving and filing an application append one
+ * line to config.journal next to them instead of rewriting the snapshot:
+ *
+ *     <generation> \t hide \t <app>
+ *     <generation> \t move \t <app> \t <index>
+ *     <generation> \t folder \t <id> \t <name> \t <icon>
+ *     <generation> \t file \t <app> \t <folder id>
+ *
+ * with the fields g_strescape()d. Applications go by desktop id, or by
+ * name for the odd entry that has none. Changes are collected for
+ * CONFIG_FLUSH_DELAY_MS and handed to a single writer thread that appends
+ * and fsyncs them, so a burst of drops costs one write. After
+ * CONFIG_COMPACT_OPS journal lines the snapshots are rewritten with the next
+ * generation and the journal truncated. The writer stamps lines with the
+ * generation of the snapshot on disk, which only moves on once the new
+ * config.xml is durable; if it cannot be written, later lines keep going
+ * to the old snapshot's journal. Loading replays the lines of the
+ * snapshot's generation; a torn last line or lines of an older generation
+ * (a crash between writing the snapshot and truncating the journal) are
+ * skipped.
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#define CONFIG_FLUSH_DELAY_MS  250
+#define CONFIG_COMPACT_OPS     1024
+
+struct _ConfigStore {
+    gchar *config_path;
+    gchar *layout_path;
+    gchar *journal_path;
+    GThreadPool *writer;        /* one thread, so writes land in order */
+    GString *pending;           /* journal lines not handed to the writer yet */
+    guint flush_id;
+    guint generation;           /* of the last snapshot handed to the writer */
+    guint disk_generation;      /* writer only: of the snapshot on disk */
+    guint journal_lines;        /* since the snapshot */
+};
+
+/* One job for the writer thread */
+typedef struct {
+    GByteArray *layout;         /* snapshot from config_layout_build(), NULL to append */
+    guint generation;           /* of layout */
+    GString *lines;             /* journal lines without their generation, with a
+                                 * layout the ones it covers */
+} ConfigWrite;
+
+static gboolean write_all(gint fd, const gchar *data, gsize length) {
+    while (length > 0) {
+        gssize written = write(fd, data, length);
+        
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written < 0)
+            return FALSE;
+        data += written;
+        length -= written;
+    }
+    return TRUE;
+}
+
+/* Write lines to the journal under the generation on disk and wait for
+ * the disk, truncating it first if asked to */
+static void write_journal(ConfigStore *store, const GString *lines, gboolean truncate) {
+    gint flags = O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : O_APPEND);
+    gint fd = open(store->journal_path, flags, 0600);
+    GString *stamped = g_string_sized_new(lines->len + 16);
+    const gchar *line, *end;
+    
+    for (line = lines->str; (end = strchr(line, '\n')) != NULL; line = end + 1) {
+        g_string_append_printf(stamped, "%u", store->disk_generation);
+        g_string_append_len(stamped, line, end - line + 1);
+    }
+    
+    if (fd < 0 || !write_all(fd, stamped->str, stamped->len) || fsync(fd) < 0)
+        g_warning("Failed to write %s: %s", store->journal_path, g_strerror(errno));
+    if (fd >= 0)
+        close(fd);
+    g_string_free(stamped, TRUE);
+}
+
+static void write_job(gpointer data, gpointer user_data) {
+    ConfigWrite *write = data;
+    ConfigStore *store = user_data;
+    GError *error = NULL;
+    
+    if (write->layout) {
+        gchar *xml = config_layout_to_xml(write->layout);
+        GFileSetContentsFlags flags = G_FILE_SET_CONTENTS_CONSISTENT | G_FILE_SET_CONTENTS_DURABLE;
+        
+        /* layout.bin goes second so that it is the newer file. Once
+         * config.xml is durable it is what loads, even if layout.bin then
+         * fails and is left older, so its generation takes over and the
+         * old journal can go. */
+        if (g_file_set_contents_full(store->config_path, xml, -1, flags, 0600, &error)) {
+            store->disk_generation = write->generation;
+            if (!g_file_set_contents_full(store->layout_path, (const gchar *)write->layout->data,
+                                          write->layout->len, flags, 0600, &error)) {
+                g_warning("Failed to save %s: %s", store->layout_path, error->message);
+                g_clear_error(&error);
+            }
+            g_string_truncate(write->lines, 0);
+            write_journal(store, write->lines, TRUE);
+        } else {
+            /* The snapshot on disk stays, so do the lines it lacks */
+            g_warning("Failed to save configuration: %s", error->message);
+            g_error_free(error);
+            write_journal(store, write->lines, FALSE);
+        }
+        g_free(xml);
+        g_byte_array_free(write->layout, TRUE);
+    } else {
+        write_journal(store, write->lines, FALSE);
+    }
+    
+    g_string_free(write->lines, TRUE);
+    g_slice_free(ConfigWrite, write);
+}
+
+static ConfigStore* config_store_get(Catalog *catalog) {
+    ConfigStore *store = catalog->config_store;
+    gchar *dir;
+    
+    if (store)
+        return store;
+    
+    store = g_new0(ConfigStore, 1);
+    store->config_path = get_config_file_path();
+    store->layout_path = config_layout_get_path();
+    dir = g_path_get_dirname(store->config_path);
+    store->journal_path = g_build_filename(dir, "config.journal", NULL);
+    g_mkdir_with_parents(dir, 0700);
+    g_free(dir);
+    
+    store->writer = g_thread_pool_new(write_job, store, 1, FALSE, NULL);
+    store->pending = g_string_new(NULL);
+    catalog->config_store = store;
+    return store;
+}
+
+static void push_write(ConfigStore *store, GByteArray *layout, GString *lines) {
+    ConfigWrite *write = g_slice_new(ConfigWrite);
+    
+    write->layout = layout;
+    write->generation = store->generation;
+    write->lines = lines;
+    g_thread_pool_push(store->writer, write, NULL);
+}
+
+/* Hand the collected lines to the writer */
+static void flush_pending(ConfigStore *store) {
+    g_clear_handle_id(&store->flush_id, g_source_remove);
+    
+    if (store->pending->len == 0)
+        return;
+    push_write(store, NULL, store->pending);
+    store->pending = g_string_new(NULL);
+}
+
+static gboolean on_flush_timeout(gpointer data) {
+    ConfigStore *store = data;
+    
+    store->flush_id = 0;
+    flush_pending(store);
+    return G_SOURCE_REMOVE;
+}
+
+static const gchar* app_key(AppInfo *app) {
+    return app->desktop_id ? app->desktop_id : app->name;
+}
+
+/* Append one journal line, fields is NULL terminated */
+static void record(LauncherPlugin *launcher, const gchar * const *fields) {
+    Catalog *catalog = launcher->catalog;
+    ConfigStore *store;
+    
+    /* Held back like save_configuration(); the snapshot written once the
+     * saved layout is applied covers the change */
+    if (!catalog->config_loaded) {
+        catalog->config_dirty = TRUE;
+        return;
+    }
+    
+    /* The writer puts the generation in front */
+    store = config_store_get(catalog);
+    for (gint i = 0; fields[i] != NULL; i++) {
+        gchar *escaped = g_strescape(fields[i], NULL);
+        
+        g_string_append_c(store->pending, '\t');
+        g_string_append(store->pending, escaped);
+        g_free(escaped);
+    }
+    g_string_append_c(store->pending, '\n');
+    
+    if (++store->journal_lines >= CONFIG_COMPACT_OPS)
+        config_store_compact(catalog);
+    else if (!store->flush_id)
+        store->flush_id = g_timeout_add(CONFIG_FLUSH_DELAY_MS, on_flush_timeout, store);
+}
+
+void config_record_hide(LauncherPlugin *launcher, AppInfo *app) {
+    const gchar *fields[] = { "hide", app_key(app), NULL };
+    
+    record(launcher, fields);
+}
+
+/* app now sits at index of the catalog, positions were recalculated */
+void config_record_move(LauncherPlugin *launcher, AppInfo *app, guint index) {
+    gchar *position = g_strdup_printf("%u", index);
+    const gchar *fields[] = { "move", app_key(app), position, NULL };
+    
+    record(launcher, fields);
+    g_free(position);
+}
+
+void config_record_folder(LauncherPlugin *launcher, FolderInfo *folder) {
+    const gchar *fields[] = { "folder", folder->id, folder->name, folder->icon, NULL };
+    
+    record(launcher, fields);
+}
+
+void config_record_file(LauncherPlugin *launcher, AppInfo *app, const gchar *folder_id) {
+    const gchar *fields[] = { "file", app_key(app), folder_id, NULL };
+    
+    record(launcher, fields);
+}
+
+/* Rewrite layout.bin and config.xml with the whole layout under the next
+ * generation, the pending and journaled lines are part of it. Should the
+ * write fail, the journal is kept and lines go on to the old generation. */
+void config_store_compact(Catalog *catalog) {
+    ConfigStore *store = config_store_get(catalog);
+    
+    g_clear_handle_id(&store->flush_id, g_source_remove);
+    store->journal_lines = 0;
+    store->generation++;
+    
+    /* The pending lines are only written if the snapshot is not */
+    push_write(store, config_layout_build(catalog, store->generation), store->pending);
+    store->pending = g_string_new(NULL);
+}
+
+/* Write everything recorded so far and wait for it */
+void config_store_sync(Catalog *catalog) {
+    ConfigStore *store = catalog->config_store;
+    
+    if (!store)
+        return;
+    
+    flush_pending(store);
+    g_thread_pool_free(store->writer, FALSE, TRUE);
+    store->writer = g_thread_pool_new(write_job, store, 1, FALSE, NULL);
+}
+
+void config_store_free(Catalog *catalog) {
+    ConfigStore *store = catalog->config_store;
+    
+    if (!store)
+        return;
+    
+    flush_pending(store);
+    g_thread_pool_free(store->writer, FALSE, TRUE);
+    g_string_free(store->pending, TRUE);
+    g_free(store->journal_path);
+    g_free(store->layout_path);
+    g_free(store->config_path);
+    g_free(store);
+    catalog->config_store = NULL;
+}
+
+/* Apply one journal line, FALSE if it is not understood */
+static gboolean replay_line(LauncherPlugin *launcher, GHashTable **by_name,
+                            gchar **fields, guint n_fields) {
+    Catalog *catalog = launcher->catalog;
+    const gchar *op = fields[0];
+    AppInfo *app;
+    guint index;
+    
+    if (strcmp(op, "folder") == 0 && n_fields == 4) {
+        if (!find_folder_by_id(launcher, fields[1])) {
+            FolderInfo *folder = create_folder(fields[2]);
+            
+            g_free(folder->id);
+            folder->id = g_strdup(fields[1]);
+            g_free(folder->icon);
+            folder->icon = g_strdup(fields[3]);
+            catalog->folder_list = g_list_append(catalog->folder_list, folder);
+        }
+        return TRUE;
+    }
+    
+    if (n_fields < 2)
+        return FALSE;
+    
+    /* Applications that are gone are skipped, as in the snapshot */
+    app = config_find_app(catalog, by_name, fields[1], fields[1]);
+    if (strcmp(op, "hide") == 0 && n_fields == 2) {
+        if (app)
+            app->is_hidden = TRUE;
+    } else if (strcmp(op, "move") == 0 && n_fields == 3) {
+        if (app && g_ptr_array_find(catalog->apps, app, &index)) {
+            g_ptr_array_steal_index(catalog->apps, index);
+            index = (guint)g_ascii_strtoull(fields[2], NULL, 10);
+            g_ptr_array_insert(catalog->apps, MIN(index, catalog->apps->len), app);
+            recalculate_positions(launcher);
+        }
+    } else if (strcmp(op, "file") == 0 && n_fields == 3) {
+        add_app_to_folder(launcher, app, fields[2]);
+    } else {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* Apply the journal on top of the snapshot of the given generation */
+void config_store_replay(LauncherPlugin *launcher, guint generation) {
+    ConfigStore *store = config_store_get(launcher->catalog);
+    gchar *contents = NULL;
+    gchar *line, *end;
+    GHashTable *by_name = NULL;
+    guint replayed = 0, skipped = 0;
+    
+    store->generation = generation;
+    store->disk_generation = generation;
+    store->journal_lines = 0;
+    
+    if (!g_file_get_contents(store->journal_path, &contents, NULL, NULL))
+        return;
+    
+    /* Only complete lines, the last one may have been cut short */
+    for (line = contents; (end = strchr(line, '\n')) != NULL; line = end + 1) {
+        gchar **fields;
+        guint n_fields;
+        gchar *tail;
+        
+        *end = '\0';
+        fields = g_strsplit(line, "\t", 0);
+        n_fields = g_strv_length(fields);
+        
+        if (n_fields >= 2 && g_ascii_strtoull(fields[0], &tail, 10) == generation &&
+            tail != fields[0] && *tail == '\0') {
+            for (guint i = 1; i < n_fields; i++) {
+                gchar *value = g_strcompress(fields[i]);
+                
+                g_free(fields[i]);
+                fields[i] = value;
+            }
+            if (replay_line(launcher, &by_name, fields + 1, n_fields - 1))
+                replayed++;
+            else
+                skipped++;
+        } else {
+            skipped++;
+        }
+        g_strfreev(fields);
+    }
+    
+    if (by_name)
+        g_hash_table_destroy(by_name);
+    store->journal_lines = replayed;
+    if (replayed || skipped)
+        g_debug("Configuration journal: %u changes replayed, %u skipped", replayed, skipped);
+    g_free(contents);
+}
@@ -25,50 +25,26 @@ gchar* get_config_file_path(void) {
     return g_build_filename(g_get_user_config_dir(), "xfce4", "launcher", "config.xml", NULL);
 }
 
-void save_configuration(LauncherPlugin *launcher) {
-    gchar *config_path = get_config_file_path();
-    gchar *config_dir = g_path_get_dirname(config_path);
-    GString *xml;
-    GList *iter;
-    
-    /* Create config directory if it doesn't exist */
-    g_mkdir_with_parents(config_dir, 0700);
-    
-    /* Build XML content */
-    xml = g_string_new("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
-    g_string_append(xml, "<launcher-config>\n");
-    
-    /* Save folders */
-    g_string_append(xml, "  <folders>\n");
-    for (iter = launcher->folder_list; iter != NULL; iter = g_list_next(iter)) {
-        FolderInfo *folder = (FolderInfo *)iter->data;
-        g_string_append_printf(xml, "    <folder id=\"%s\" name=\"%s\" icon=\"%s\"/>\n",
-                              folder->id, folder->name, folder->icon);
-    }
-    g_string_append(xml, "  </folders>\n");
+/* The whole layout as config.xml contents, see config-store.c for generation */
+gchar* config_build_snapshot(Catalog *catalog, guint generation) {
+    GByteArray *layout = config_layout_build(catalog, generation);
+    gchar *xml = config_layout_to_xml(layout);
     
-    /* Save app states */
-    g_string_append(xml, "  <apps>\n");
-    for (iter = launcher->app_list; iter != NULL; iter = g_list_next(iter)) {
-        AppInfo *app = (AppInfo *)iter->data;
-        if (app->is_hidden || app->folder_id || app->position != -1) {
-            g_string_append_printf(xml, "    <app name=\"%s\" hidden=\"%s\" position=\"%d\"",
-                                  app->name, app->is_hidden ? "true" : "false", app->position);
-            if (app->folder_id) {
-                g_string_append_printf(xml, " folder=\"%s\"", app->folder_id);
-            }
-            g_string_append(xml, "/>\n");
-        }
+    g_byte_array_free(layout, TRUE);
+    return xml;
+}
+
+/* Write the whole layout, off the main loop. Single changes go to the
+ * journal through the config_record_*() functions instead. */
+void save_configuration(LauncherPlugin *launcher) {
+    /* Writing before the saved layout was applied would drop entries for
+     * applications that are still being discovered */
+    if (!launcher->catalog->config_loaded) {
+        launcher->catalog->config_dirty = TRUE;
+        return;
     }
-    g_string_append(xml, "  </apps>\n");
-    g_string_append(xml, "</launcher-config>\n");
     
-    /* Write to file */
-    g_file_set_contents(config_path, xml->str, xml->len, NULL);
-    
-    g_string_free(xml, TRUE);
-    g_free(config_dir);
-    g_free(config_path);
+    config_store_compact(launcher->catalog);
 }
 
 /* User data for GMarkup parser */
@@ -76,8 +52,36 @@ typedef struct {
     LauncherPlugin *launcher;
     gboolean in_folders;
     gboolean in_apps;
+    guint generation;
+    GHashTable *by_name;
+    guint migrated;             /* entries only found by name */
 } ParserData;
 
+/* The entry a config.xml or journal entry refers to, by desktop id, else
+ * by display name as in files written before desktop ids were stored.
+ * The name index is built on first use, the caller frees it. */
+AppInfo* config_find_app(Catalog *catalog, GHashTable **by_name, const gchar *desktop_id,
+                         const gchar *name) {
+    AppInfo *app = NULL;
+    
+    if (desktop_id && catalog->app_index)
+        app = g_hash_table_lookup(catalog->app_index, desktop_id);
+    if (app || !name)
+        return app;
+    
+    if (!*by_name) {
+        *by_name = g_hash_table_new(g_str_hash, g_str_equal);
+        for (guint i = 0; i < catalog->apps->len; i++) {
+            AppInfo *entry = g_ptr_array_index(catalog->apps, i);
+            
+            /* The first of several entries with one name wins, as before */
+            if (entry->name && !g_hash_table_contains(*by_name, entry->name))
+                g_hash_table_insert(*by_name, (gpointer)entry->name, entry);
+        }
+    }
+    return g_hash_table_lookup(*by_name, name);
+}
+
 /* GMarkup parser callbacks */
 static void start_element(GMarkupParseContext *context,
                         const gchar *element_name,
@@ -87,7 +91,12 @@ static void start_element(GMarkupParseContext *context,
                         GError **error) {
     ParserData *data = (ParserData *)user_data;
 
-    if (strcmp(element_name, "folders") == 0) {
+    if (strcmp(element_name, "launcher-config") == 0) {
+        for (int i = 0; attribute_names[i]; i++) {
+            if (strcmp(attribute_names[i], "generation") == 0)
+                data->generation = (guint)g_ascii_strtoull(attribute_values[i], NULL, 10);
+        }
+    } else if (strcmp(element_name, "folders") == 0) {
         data->in_folders = TRUE;
     } else if (strcmp(element_name, "apps") == 0) {
         data->in_apps = TRUE;
@@ -106,28 +115,25 @@ static void start_element(GMarkupParseContext *context,
                 g_free(folder->icon);
                 folder->icon = g_strdup(icon);
             }
-            data->launcher->folder_list = g_list_append(data->launcher->folder_list, folder);
+            data->launcher->catalog->folder_list = g_list_append(data->launcher->catalog->folder_list, folder);
         }
     } else if (strcmp(element_name, "app") == 0 && data->in_apps) {
-        const gchar *name = NULL, *hidden = NULL, *folder = NULL, *position = NULL;
+        const gchar *id = NULL, *name = NULL, *hidden = NULL, *folder = NULL, *position = NULL;
+        AppInfo *app;
         for (int i = 0; attribute_names[i]; i++) {
+            if (strcmp(attribute_names[i], "id") == 0) id = attribute_values[i];
             if (strcmp(attribute_names[i], "name") == 0) name = attribute_values[i];
             if (strcmp(attribute_names[i], "hidden") == 0) hidden = attribute_values[i];
             if (strcmp(attribute_names[i], "folder") == 0) folder = attribute_values[i];
             if (strcmp(attribute_names[i], "position") == 0) position = attribute_values[i];
         }
 
-        if (name) {
-            GList *iter;
-            for (iter = data->launcher->app_list; iter != NULL; iter = g_list_next(iter)) {
-                AppInfo *app = (AppInfo *)iter->data;
-                if (strcmp(app->name, name) == 0) {
-                    if (hidden && strcmp(hidden, "true") == 0) app->is_hidden = TRUE;
-                    if (folder) app->folder_id = g_strdup(folder);
-                    if (position) app->position = atoi(position);
-                    break;
-                }
-            }
+        app = config_find_app(data->launcher->catalog, &data->by_name, id, name);
+        if (app) {
+            if (hidden && strcmp(hidden, "true") == 0) app->is_hidden = TRUE;
+            if (folder) add_app_to_folder(data->launcher, app, folder);
+            if (position) app->position = atoi(position);
+            if (!id && app->desktop_id) data->migrated++;
         }
     }
 }
@@ -144,54 +150,58 @@ static void end_element(GMarkupParseContext *context,
     }
 }
 
-static gint sort_apps_by_position(gconstpointer a, gconstpointer b) {
-    const AppInfo *app_a = *(const AppInfo **)a;
-    const AppInfo *app_b = *(const AppInfo **)b;
-
-    if (app_a->position == -1 && app_b->position == -1) {
-        return g_utf8_collate(app_a->name, app_b->name);
-    }
-    if (app_a->position == -1) return 1;
-    if (app_b->position == -1) return -1;
-    return app_a->position - app_b->position;
-}
-
-
-void load_configuration(LauncherPlugin *launcher) {
+/* Apply config.xml, the portable copy of the layout */
+static void import_xml(ParserData *data) {
     gchar *config_path = get_config_file_path();
     gchar *contents = NULL;
     gsize length;
     GError *error = NULL;
 
-    if (!g_file_get_contents(config_path, &contents, &length, &error)) {
-        if (error) {
-            g_warning("Failed to read config file: %s", error->message);
+    if (g_file_get_contents(config_path, &contents, &length, &error)) {
+        GMarkupParser parser = {
+            .start_element = start_element,
+            .end_element = end_element,
+            .text = NULL,
+            .passthrough = NULL,
+            .error = NULL
+        };
+        GMarkupParseContext *context = g_markup_parse_context_new(&parser, 0, data, NULL);
+        
+        if (!g_markup_parse_context_parse(context, contents, length, &error)) {
+            g_warning("Failed to parse config file: %s", error->message);
             g_error_free(error);
         }
-        g_free(config_path);
-        return;
+        g_markup_parse_context_free(context);
+        g_free(contents);
+    } else {
+        /* A first start has no snapshot, but may have a journal */
+        if (!g_error_matches(error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+            g_warning("Failed to read config file: %s", error->message);
+        g_error_free(error);
     }
+    g_free(config_path);
+}
 
+/* Apply layout.bin, or config.xml when that is newer, then the journal
+ * written since. Entries are found through the catalog's desktop-id
+ * index, which must be current. */
+void load_configuration(LauncherPlugin *launcher) {
+    gint64 start = trace_begin();
     ParserData data = { .launcher = launcher, .in_folders = FALSE, .in_apps = FALSE };
-    GMarkupParser parser = {
-        .start_element = start_element,
-        .end_element = end_element,
-        .text = NULL,
-        .passthrough = NULL,
-        .error = NULL
-    };
-
-    GMarkupParseContext *context = g_markup_parse_context_new(&parser, 0, &data, NULL);
-    if (!g_markup_parse_context_parse(context, contents, length, &error)) {
-        if (error) {
-            g_warning("Failed to parse config file: %s", error->message);
-            g_error_free(error);
-        }
-    }
+
+    if (!config_layout_load(launcher, &data.generation))
+        import_xml(&data);
+    if (data.by_name)
+        g_hash_table_destroy(data.by_name);
     
-    g_markup_parse_context_free(context);
-    g_free(contents);
-    g_free(config_path);
+    /* Name keyed files are rewritten with desktop ids once loading is done */
+    if (data.migrated) {
+        g_debug("Configuration: %u entries matched by name", data.migrated);
+        launcher->catalog->config_dirty = TRUE;
+    }
 
-    launcher->app_list = g_list_sort(launcher->app_list, (GCompareFunc)sort_apps_by_position);
+    g_ptr_array_sort(launcher->catalog->apps, compare_app_position_entries);
+    config_store_replay(launcher, data.generation);
+    search_index_invalidate(launcher->catalog);
+    trace_end(TRACE_LOAD_CONFIGURATION, start);
 }
@@ -30,17 +30,13 @@ gboolean on_key_press(GtkWidget *widget, GdkEventKey *event, LauncherPlugin *lau
             return TRUE;
         case GDK_KEY_Right:
             if (launcher->current_page < launcher->total_pages - 1) {
-                launcher->current_page++;
-                populate_current_page(launcher);
-                update_page_dots(launcher);
+                show_page(launcher, launcher->current_page + 1);
                 return TRUE;
             }
             break;
         case GDK_KEY_Left:
             if (launcher->current_page > 0) {
-                launcher->current_page--;
-                populate_current_page(launcher);
-                update_page_dots(launcher);
+                show_page(launcher, launcher->current_page - 1);
                 return TRUE;
             }
             break;
@@ -50,36 +46,27 @@ gboolean on_key_press(GtkWidget *widget, GdkEventKey *event, LauncherPlugin *lau
 
 void on_search_changed(GtkSearchEntry *entry, LauncherPlugin *launcher) {
     const gchar *search_text = gtk_entry_get_text(GTK_ENTRY(entry));
-    GList *iter;
-    
-    if (launcher->filtered_list) {
-        g_list_free(launcher->filtered_list);
-    }
-    
-    launcher->filtered_list = NULL;
+    gint64 start = trace_begin();
     
     if (strlen(search_text) == 0) {
-        launcher->filtered_list = g_list_copy(launcher->app_list);
+        catalog_fill_view(launcher);
     } else {
-        gchar *search_lower = g_utf8_strdown(search_text, -1);
+        AppInfo *likely;
         
-        for (iter = launcher->app_list; iter != NULL; iter = g_list_next(iter)) {
-            AppInfo *app_info = (AppInfo *)iter->data;
-            if (app_info && app_info->name && !app_info->is_hidden) {
-                gchar *name_lower = g_utf8_strdown(app_info->name, -1);
-                if (strstr(name_lower, search_lower) != NULL) {
-                    launcher->filtered_list = g_list_append(launcher->filtered_list, app_info);
-                }
-                g_free(name_lower);
-            }
-        }
+        g_ptr_array_unref(launcher->filtered);
+        launcher->filtered = search_index_query(launcher, search_text);
         
-        g_free(search_lower);
+        /* Start reading the application in while the user keeps typing */
+        likely = search_index_dominant_match(launcher);
+        if (likely)
+            prewarm_application(launcher, likely);
     }
     
     launcher->current_page = 0;
+    scroll_view_reset(launcher);
     populate_current_page(launcher);
     update_page_dots(launcher);
+    trace_end(TRACE_SEARCH, start);
 }
 
 void on_dot_clicked(GtkWidget *dot, gpointer data) {
@@ -87,20 +74,23 @@ void on_dot_clicked(GtkWidget *dot, gpointer data) {
     LauncherPlugin *launcher = g_object_get_data(G_OBJECT(dot), "launcher");
     
     if (launcher && page_index != launcher->current_page) {
-        launcher->current_page = page_index;
-        populate_current_page(launcher);
-        update_page_dots(launcher);
+        show_page(launcher, page_index);
     }
 }
 
 gboolean on_scroll_event(GtkWidget *widget, GdkEventScroll *event, LauncherPlugin *launcher) {
+    gint page = launcher->current_page;
     gboolean changed = FALSE;
     
+    /* The scrolled window takes the events over the list itself */
+    if (launcher->scroll_view)
+        return FALSE;
+    
     switch (event->direction) {
         case GDK_SCROLL_LEFT:
         case GDK_SCROLL_UP:
             if (launcher->current_page > 0) {
-                launcher->current_page--;
+                page--;
                 changed = TRUE;
             }
             break;
@@ -108,7 +98,7 @@ gboolean on_scroll_event(GtkWidget *widget, GdkEventScroll *event, LauncherPlugi
         case GDK_SCROLL_RIGHT:
         case GDK_SCROLL_DOWN:
             if (launcher->current_page < launcher->total_pages - 1) {
-                launcher->current_page++;
+                page++;
                 changed = TRUE;
             }
             break;
@@ -117,24 +107,24 @@ gboolean on_scroll_event(GtkWidget *widget, GdkEventScroll *event, LauncherPlugi
             if (fabs(event->delta_x) > fabs(event->delta_y)) {
                 if (event->delta_x < -0.3) {
                     if (launcher->current_page > 0) {
-                        launcher->current_page--;
+                        page--;
                         changed = TRUE;
                     }
                 } else if (event->delta_x > 0.3) {
                     if (launcher->current_page < launcher->total_pages - 1) {
-                        launcher->current_page++;
+                        page++;
                         changed = TRUE;
                     }
                 }
             } else {
                 if (event->delta_y < -0.3) {
                     if (launcher->current_page > 0) {
-                        launcher->current_page--;
+                        page--;
                         changed = TRUE;
                     }
                 } else if (event->delta_y > 0.3) {
                     if (launcher->current_page < launcher->total_pages - 1) {
-                        launcher->current_page++;
+                        page++;
                         changed = TRUE;
                     }
                 }
@@ -146,27 +136,26 @@ gboolean on_scroll_event(GtkWidget *widget, GdkEventScroll *event, LauncherPlugi
     }
     
     if (changed) {
-        populate_current_page(launcher);
-        update_page_dots(launcher);
+        show_page(launcher, page);
     }
     
     return TRUE;
 }
 
 void on_swipe_gesture(GtkGestureSwipe *gesture, gdouble velocity_x, gdouble velocity_y, LauncherPlugin *launcher) {
+    gint page = launcher->current_page;
     gboolean changed = FALSE;
     
     if (velocity_x > 0 && launcher->current_page > 0) {
-        launcher->current_page--;
+        page--;
         changed = TRUE;
     } else if (velocity_x < 0 && launcher->current_page < launcher->total_pages - 1) {
-        launcher->current_page++;
+        page++;
         changed = TRUE;
     }
     
     if (changed) {
-        populate_current_page(launcher);
-        update_page_dots(launcher);
+        show_page(launcher, page);
     }
 }
 
@@ -182,9 +171,11 @@ void on_folder_clicked(GtkWidget *button, FolderInfo *folder_info) {
     LauncherPlugin *launcher = g_object_get_data(G_OBJECT(button), "launcher");
     if (launcher) {
         launcher->open_folder = folder_info;
-        g_list_free(launcher->filtered_list);
-        launcher->filtered_list = g_list_copy(folder_info->apps);
+        g_ptr_array_set_size(launcher->filtered, 0);
+        for (guint i = 0; i < folder_info->apps->len; i++)
+            g_ptr_array_add(launcher->filtered, g_ptr_array_index(folder_info->apps, i));
         launcher->current_page = 0;
+        scroll_view_reset(launcher);
         populate_current_page(launcher);
         update_page_dots(launcher);
         gtk_widget_show(launcher->back_button);
@@ -193,9 +184,9 @@ void on_folder_clicked(GtkWidget *button, FolderInfo *folder_info) {
 
 void on_back_button_clicked(GtkWidget *button, LauncherPlugin *launcher) {
     launcher->open_folder = NULL;
-    g_list_free(launcher->filtered_list);
-    launcher->filtered_list = g_list_copy(launcher->app_list);
+    catalog_fill_view(launcher);
     launcher->current_page = 0;
+    scroll_view_reset(launcher);
     populate_current_page(launcher);
     update_page_dots(launcher);
     gtk_widget_hide(launcher->back_button);
@@ -243,6 +234,7 @@ void on_drag_data_received(GtkWidget *widget, GdkDragContext *context, gint x, g
 
     if (app_info && folder_info) {
         add_app_to_folder(launcher, app_info, folder_info->id);
+        config_record_file(launcher, app_info, folder_info->id);
         populate_current_page(launcher);
     }
     gtk_drag_finish(context, TRUE, FALSE, time);
@@ -261,7 +253,16 @@ gboolean on_drag_drop(GtkWidget *widget, GdkDragContext *context, gint x, gint y
         return FALSE;
     }
 
-    GtkWidget *target_widget = gtk_grid_get_child_at(GTK_GRID(launcher->app_grid), x / BUTTON_SIZE, y / BUTTON_SIZE);
+    /* The cell under the pointer, with the geometry the grid was built with;
+     * in scroll mode the grid holds the bound rows */
+    gint rows = launcher->scroll_view ?
+                (gint)((scroll_view_get_end_index(launcher) - scroll_view_get_first_index(launcher)) /
+                       launcher->geometry.columns) :
+                launcher->geometry.rows;
+    gint cell = grid_geometry_cell_at(&launcher->geometry, rows, x, y);
+    GtkWidget *target_widget = gtk_grid_get_child_at(GTK_GRID(launcher->app_grid),
+                                                     cell % launcher->geometry.columns,
+                                                     cell / launcher->geometry.columns);
     AppInfo *target_app = target_widget ? g_object_get_data(G_OBJECT(target_widget), "app-info") : NULL;
     FolderInfo *target_folder = target_widget ? g_object_get_data(G_OBJECT(target_widget), "folder-info") : NULL;
 
@@ -270,32 +271,48 @@ gboolean on_drag_drop(GtkWidget *widget, GdkDragContext *context, gint x, gint y
     if (target_app && launcher->drag_source != target_app) {
         /* Dropped on another app -> create a folder */
         FolderInfo *folder = create_folder("New Folder");
-        launcher->folder_list = g_list_append(launcher->folder_list, folder);
+        launcher->catalog->folder_list = g_list_append(launcher->catalog->folder_list, folder);
+        config_record_folder(launcher, folder);
 
         add_app_to_folder(launcher, launcher->drag_source, folder->id);
         add_app_to_folder(launcher, target_app, folder->id);
+        config_record_file(launcher, launcher->drag_source, folder->id);
+        config_record_file(launcher, target_app, folder->id);
 
         success = TRUE;
     } else if (target_folder) {
         /* Dropped on a folder -> add to folder */
         add_app_to_folder(launcher, launcher->drag_source, target_folder->id);
+        config_record_file(launcher, launcher->drag_source, target_folder->id);
         success = TRUE;
     } else {
         /* Dropped on empty space -> reorder */
-        gint page_offset = launcher->current_page * APPS_PER_PAGE;
-        gint new_index = (y / BUTTON_SIZE) * GRID_COLUMNS + (x / BUTTON_SIZE) + page_offset;
+        gint page_offset = launcher->scroll_view ? (gint)scroll_view_get_first_index(launcher) :
+                           launcher->current_page * launcher->geometry.apps_per_page;
+        gint new_index = cell + page_offset;
 
-        launcher->app_list = g_list_remove(launcher->app_list, launcher->drag_source);
-        launcher->app_list = g_list_insert(launcher->app_list, launcher->drag_source, new_index);
+        GPtrArray *apps = launcher->catalog->apps;
+        guint old_index;
+        
+        if (g_ptr_array_find(apps, launcher->drag_source, &old_index)) {
+            g_ptr_array_steal_index(apps, old_index);
+            new_index = MIN(new_index, (gint)apps->len);
+            g_ptr_array_insert(apps, new_index, launcher->drag_source);
+            config_record_move(launcher, launcher->drag_source, new_index);
+        }
 
         recalculate_positions(launcher);
+        search_index_invalidate(launcher->catalog);
         success = TRUE;
     }
 
     if (success) {
+        /* Filed entries leave the grid, moved ones change places */
+        if (!launcher->open_folder)
+            catalog_fill_view(launcher);
         populate_current_page(launcher);
         update_page_dots(launcher);
-        save_configuration(launcher);
+        catalog_refresh_views(launcher->catalog, launcher);
         gtk_drag_finish(context, TRUE, FALSE, time);
         return TRUE;
     }
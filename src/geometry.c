@@ -0,0 +1,166 @@
+/*
+ * XFCE Launcher Plugin v0.7
+ *
+ * Changelog:
+ * - Hotkey setting to toggle the launcher (integrates with XFCE custom keyboard shortcuts)
+ * - Drag & drop improvements: reorder apps, create folders, add apps to folders
+ * - Search result highlighting (matched text in app names is highlighted)
+ * - Responsive layout: grid size, icon size, and spacing adapt to the current screen resolution
+ * - Settings dialog updated (includes hotkey configuration)
+ * - Configuration saving is more robust (XML attribute escaping)
+ * - Fixed broken drag-and-drop behavior
+ * - Fixed potential memory leak when loading configuration (folder id replacement)
+ * - Fixed callback type mismatches and reduced build warnings
+
+ * Grid geometry
+ *
+ * Columns, rows, icon and tile size and the spacing between tiles follow
+ * the workarea of the monitor the launcher opens on. The icon size is
+ * picked from a few theme sizes by the workarea height, the tile size
+ * follows from it, and as many columns and rows as fit below the search
+ * field and recent row are used, within bounds. The room those take is
+ * worked out in ui.c from the same sizes as its CSS. Sizes are in logical
+ * pixels; the monitor's scale factor decides the pixel size icons are
+ * decoded at. Results are kept per monitor configuration, so reopening
+ * the launcher on the same monitor finds the overlay laid out already.
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <math.h>
+#include <string.h>
+
+#define GEOMETRY_SIDE_MARGIN    0.1     /* of the workarea width, on either side */
+#define GEOMETRY_MIN_COLUMNS    3
+#define GEOMETRY_MAX_COLUMNS    10
+#define GEOMETRY_MIN_ROWS       2
+#define GEOMETRY_MAX_ROWS       8
+
+static const gint icon_sizes[] = { 48, 64, 96, 128 };
+
+static void set_default(GridGeometry *geometry) {
+    geometry->columns = DEFAULT_GRID_COLUMNS;
+    geometry->rows = DEFAULT_GRID_ROWS;
+    geometry->apps_per_page = DEFAULT_GRID_COLUMNS * DEFAULT_GRID_ROWS;
+    geometry->icon_size = DEFAULT_ICON_SIZE;
+    geometry->button_size = DEFAULT_BUTTON_SIZE;
+    geometry->spacing = DEFAULT_GRID_SPACING;
+    geometry->scale = 1;
+}
+
+static void compute(GridGeometry *geometry, const GdkRectangle *workarea, gint scale) {
+    /* DEFAULT_ICON_SIZE on a 1080 line workarea */
+    gdouble wanted = workarea->height * DEFAULT_ICON_SIZE / 1080.0;
+    gint pitch, width, height;
+    
+    geometry->icon_size = icon_sizes[0];
+    for (guint i = 1; i < G_N_ELEMENTS(icon_sizes); i++) {
+        if (fabs(icon_sizes[i] - wanted) < fabs(geometry->icon_size - wanted))
+            geometry->icon_size = icon_sizes[i];
+    }
+    
+    /* The label below the icon takes the same room at every size */
+    geometry->button_size = geometry->icon_size + DEFAULT_BUTTON_SIZE - DEFAULT_ICON_SIZE;
+    geometry->spacing = geometry->icon_size / 4 + DEFAULT_GRID_SPACING - DEFAULT_ICON_SIZE / 4;
+    geometry->scale = scale;
+    
+    /* The recent row takes one row of tiles above the grid */
+    pitch = grid_geometry_get_pitch(geometry);
+    width = (gint)(workarea->width * (1.0 - 2 * GEOMETRY_SIDE_MARGIN));
+    height = workarea->height - get_chrome_height() - pitch;
+    geometry->columns = CLAMP((width + geometry->spacing) / pitch,
+                              GEOMETRY_MIN_COLUMNS, GEOMETRY_MAX_COLUMNS);
+    geometry->rows = CLAMP((height + geometry->spacing) / pitch,
+                           GEOMETRY_MIN_ROWS, GEOMETRY_MAX_ROWS);
+    geometry->apps_per_page = geometry->columns * geometry->rows;
+}
+
+/* The monitor of the panel button, else the primary one */
+static GdkMonitor* get_monitor(LauncherPlugin *launcher, gint *monitor_num) {
+    GdkDisplay *display = gdk_display_get_default();
+    GdkWindow *window = launcher->button ? gtk_widget_get_window(launcher->button) : NULL;
+    GdkMonitor *monitor = NULL;
+    
+    *monitor_num = -1;
+    if (!display)
+        return NULL;
+    
+    if (window)
+        monitor = gdk_display_get_monitor_at_window(display, window);
+    if (!monitor)
+        monitor = gdk_display_get_primary_monitor(display);
+    if (!monitor && gdk_display_get_n_monitors(display) > 0)
+        monitor = gdk_display_get_monitor(display, 0);
+    
+    for (gint i = 0; monitor && i < gdk_display_get_n_monitors(display); i++) {
+        if (gdk_display_get_monitor(display, i) == monitor)
+            *monitor_num = i;
+    }
+    return monitor;
+}
+
+/* Geometry for the monitor launcher would open on now, and that
+ * monitor's number in monitor_num (-1 if unknown) if given. The catalog
+ * owns the result. */
+const GridGeometry* grid_geometry_for_view(LauncherPlugin *launcher, gint *monitor_num) {
+    Catalog *catalog = launcher->catalog;
+    GdkMonitor *monitor;
+    GdkRectangle workarea = { 0, 0, 0, 0 };
+    GridGeometry *geometry;
+    gchar *key;
+    gint scale = 1;
+    gint number;
+    
+    monitor = get_monitor(launcher, &number);
+    if (monitor_num)
+        *monitor_num = number;
+    if (monitor) {
+        gdk_monitor_get_workarea(monitor, &workarea);
+        scale = gdk_monitor_get_scale_factor(monitor);
+    }
+    
+    if (!catalog->geometries)
+        catalog->geometries = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    
+    key = g_strdup_printf("%d,%d,%dx%d@%d", workarea.x, workarea.y,
+                          workarea.width, workarea.height, scale);
+    geometry = g_hash_table_lookup(catalog->geometries, key);
+    if (geometry) {
+        g_free(key);
+        return geometry;
+    }
+    
+    geometry = g_new0(GridGeometry, 1);
+    if (workarea.width > 0 && workarea.height > 0)
+        compute(geometry, &workarea, scale);
+    else
+        set_default(geometry);
+    g_debug("Grid geometry for %s: %dx%d tiles of %d pixels, icons of %d",
+            key, geometry->columns, geometry->rows, geometry->button_size, geometry->icon_size);
+    
+    g_hash_table_insert(catalog->geometries, key, geometry);
+    return geometry;
+}
+
+gboolean grid_geometry_equal(const GridGeometry *a, const GridGeometry *b) {
+    return memcmp(a, b, sizeof(GridGeometry)) == 0;
+}
+
+/* Distance between the tops of two rows and the lefts of two columns */
+gint grid_geometry_get_pitch(const GridGeometry *geometry) {
+    return geometry->button_size + 2 * get_tile_margin() + geometry->spacing;
+}
+
+/* The grid cell under x, y in grid coordinates, counted row by row. Points
+ * past the edges land in the nearest of the grid's columns and its rows
+ * bound to tiles. */
+gint grid_geometry_cell_at(const GridGeometry *geometry, gint rows, gint x, gint y) {
+    gint pitch = grid_geometry_get_pitch(geometry);
+    gint column = CLAMP(x / pitch, 0, geometry->columns - 1);
+    gint row = CLAMP(y / pitch, 0, MAX(rows, 1) - 1);
+    
+    return row * geometry->columns + column;
+}
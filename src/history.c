@@ -0,0 +1,353 @@
+/*
+ * XFCE Launcher Plugin v0.7
+ *
+ * Changelog:
+ * - Hotkey setting to toggle the launcher (integrates with XFCE custom keyboard shortcuts)
+ * - Drag & drop improvements: reorder apps, create folders, add apps to folders
+ * - Search result highlighting (matched text in app names is highlighted)
+ * - Responsive layout: grid size, icon size, and spacing adapt to the current screen resolution
+ * - Settings dialog updated (includes hotkey configuration)
+ * - Configuration saving is more robust (XML attribute escaping)
+ * - Fixed broken drag-and-drop behavior
+ * - Fixed potential memory leak when loading configuration (folder id replacement)
+ * - Fixed callback type mismatches and reduced build warnings
+
+ * Launch history and frecency
+ *
+ * Every launch is appended to a plain text log in $XDG_DATA_HOME as
+ * "<unix time> <desktop-id>". In memory each desktop id has a frecency
+ * score that halves every HISTORY_HALF_LIFE; a launch decays the stored
+ * score to now and adds one, so recording is constant time. Once the
+ * log has grown by HISTORY_COMPACT_LINES launches it is rewritten as one
+ * "= <last used> <count> <score> <desktop-id>" line per entry, dropping
+ * entries that decayed below HISTORY_FORGET_SCORE, so loading stays
+ * proportional to the number of applications rather than to years of
+ * launches. The rewrite runs on a worker thread; launches recorded
+ * meanwhile are appended once it is done.
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <glib/gstdio.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define HISTORY_HALF_LIFE      (7 * 24 * 3600.0)   /* seconds */
+#define HISTORY_COMPACT_LINES  256
+#define HISTORY_FORGET_SCORE   0.05
+
+typedef struct {
+    gint64 last_used;           /* unix time of the last launch */
+    guint count;
+    gdouble score;              /* frecency as of last_used */
+} HistoryEntry;
+
+struct _LaunchHistory {
+    GHashTable *entries;        /* desktop-id -> HistoryEntry */
+    guint log_lines;            /* launches appended since the last compaction */
+    GCancellable *cancellable;  /* compaction in flight */
+    gboolean compacting;
+    guint compacted_lines;      /* log_lines when the compaction started */
+    GString *deferred;          /* launch lines held back while compacting */
+};
+
+gchar* launch_history_get_path(void) {
+    return g_build_filename(g_get_user_data_dir(), "xfce4", "launcher", "history.log", NULL);
+}
+
+static gdouble decayed_score(const HistoryEntry *entry, gint64 now) {
+    if (now <= entry->last_used)
+        return entry->score;
+    
+    return entry->score * exp2(-(now - entry->last_used) / HISTORY_HALF_LIFE);
+}
+
+static HistoryEntry* lookup_entry(LaunchHistory *history, const gchar *desktop_id) {
+    HistoryEntry *entry = g_hash_table_lookup(history->entries, desktop_id);
+    
+    if (!entry) {
+        entry = g_new0(HistoryEntry, 1);
+        g_hash_table_insert(history->entries, g_strdup(desktop_id), entry);
+    }
+    return entry;
+}
+
+static void add_launch(LaunchHistory *history, const gchar *desktop_id, gint64 when) {
+    HistoryEntry *entry = lookup_entry(history, desktop_id);
+    
+    /* Out of order launches (clock changes) count as happening now */
+    entry->score = decayed_score(entry, when) + 1.0;
+    entry->last_used = MAX(entry->last_used, when);
+    entry->count++;
+}
+
+/* Parse one log line, returns FALSE for lines that are not understood */
+static gboolean parse_line(LaunchHistory *history, gchar *line) {
+    gchar *end;
+    
+    if (line[0] == '=') {
+        /* Compacted entry */
+        gchar **fields = g_strsplit(line + 1, " ", 5);
+        gboolean valid = g_strv_length(fields) == 5 && *fields[4];
+        
+        if (valid) {
+            HistoryEntry *entry = lookup_entry(history, fields[4]);
+            
+            entry->last_used = g_ascii_strtoll(fields[1], NULL, 10);
+            entry->count = (guint)g_ascii_strtoull(fields[2], NULL, 10);
+            entry->score = g_ascii_strtod(fields[3], NULL);
+        }
+        g_strfreev(fields);
+        return valid;
+    } else {
+        gint64 when = g_ascii_strtoll(line, &end, 10);
+        
+        if (end == line || *end != ' ' || end[1] == '\0')
+            return FALSE;
+        
+        add_launch(history, end + 1, when);
+        history->log_lines++;
+        return TRUE;
+    }
+}
+
+/* Append launch lines to the log */
+static void append_log(const gchar *lines) {
+    gchar *path = launch_history_get_path();
+    FILE *log = g_fopen(path, "a");
+    
+    if (!log) {
+        gchar *dir = g_path_get_dirname(path);
+        
+        g_mkdir_with_parents(dir, 0700);
+        log = g_fopen(path, "a");
+        g_free(dir);
+    }
+    
+    if (log) {
+        fputs(lines, log);
+        fclose(log);
+    } else {
+        g_warning("Failed to append to launch history %s", path);
+    }
+    g_free(path);
+}
+
+static void free_contents(gpointer data) {
+    g_string_free((GString *)data, TRUE);
+}
+
+static void compact_history_thread(GTask *task,
+                                   gpointer source_object,
+                                   gpointer task_data,
+                                   GCancellable *cancellable) {
+    GString *contents = (GString *)task_data;
+    gchar *path = launch_history_get_path();
+    gchar *dir = g_path_get_dirname(path);
+    GError *error = NULL;
+    
+    g_mkdir_with_parents(dir, 0700);
+    if (g_file_set_contents(path, contents->str, contents->len, &error))
+        g_task_return_boolean(task, TRUE);
+    else
+        g_task_return_error(task, error);
+    
+    g_free(dir);
+    g_free(path);
+}
+
+static void on_history_compacted(GObject *source_object, GAsyncResult *result, gpointer user_data) {
+    LaunchHistory *history = (LaunchHistory *)user_data;
+    GError *error = NULL;
+    
+    /* The history is gone, see launch_history_free() */
+    if (!g_task_propagate_boolean(G_TASK(result), &error) &&
+        g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        g_error_free(error);
+        return;
+    }
+    
+    if (error) {
+        g_warning("Failed to compact launch history: %s", error->message);
+        g_error_free(error);
+    } else {
+        g_debug("Launch history compacted to %u entries", g_hash_table_size(history->entries));
+        history->log_lines -= history->compacted_lines;
+    }
+    
+    /* Launches recorded during the write go after the compacted lines */
+    if (history->deferred->len) {
+        append_log(history->deferred->str);
+        g_string_truncate(history->deferred, 0);
+    }
+    history->compacting = FALSE;
+}
+
+/* Rewrite the log as one aggregated line per remembered entry. The lines are
+ * built here and written by a worker thread, off the launch path. */
+static void compact_history(LaunchHistory *history) {
+    GHashTableIter iter;
+    gpointer key, value;
+    GString *contents;
+    gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+    GTask *task;
+    
+    if (history->compacting)
+        return;
+    
+    contents = g_string_new(NULL);
+    g_hash_table_iter_init(&iter, history->entries);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        HistoryEntry *entry = value;
+        gchar score[G_ASCII_DTOSTR_BUF_SIZE];
+        
+        if (decayed_score(entry, now) < HISTORY_FORGET_SCORE) {
+            g_hash_table_iter_remove(&iter);
+            continue;
+        }
+        
+        g_ascii_dtostr(score, sizeof(score), entry->score);
+        g_string_append_printf(contents, "= %" G_GINT64_FORMAT " %u %s %s\n",
+                               entry->last_used, entry->count, score, (const gchar *)key);
+    }
+    
+    history->compacting = TRUE;
+    history->compacted_lines = history->log_lines;
+    
+    task = g_task_new(NULL, history->cancellable, on_history_compacted, history);
+    g_task_set_task_data(task, contents, free_contents);
+    g_task_run_in_thread(task, compact_history_thread);
+    g_object_unref(task);
+}
+
+void launch_history_load(Catalog *catalog) {
+    LaunchHistory *history = g_new0(LaunchHistory, 1);
+    gchar *path = launch_history_get_path();
+    gchar *contents = NULL;
+    gsize length;
+    guint invalid = 0;
+    
+    history->entries = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    history->cancellable = g_cancellable_new();
+    history->deferred = g_string_new(NULL);
+    catalog->history = history;
+    
+    if (g_file_get_contents(path, &contents, &length, NULL)) {
+        gchar *line = contents;
+        
+        while (line < contents + length) {
+            gchar *newline = strchr(line, '\n');
+            
+            if (newline)
+                *newline = '\0';
+            if (*line && !parse_line(history, line))
+                invalid++;
+            if (!newline)
+                break;
+            line = newline + 1;
+        }
+        g_free(contents);
+    }
+    g_free(path);
+    
+    if (history->log_lines >= HISTORY_COMPACT_LINES || invalid > 0)
+        compact_history(history);
+}
+
+void launch_history_free(Catalog *catalog) {
+    LaunchHistory *history = catalog->history;
+    
+    if (!history)
+        return;
+    
+    /* A running compaction still replaces the log; launches held back for
+     * it are lost, the ones before it are in the compacted lines */
+    g_cancellable_cancel(history->cancellable);
+    g_object_unref(history->cancellable);
+    g_string_free(history->deferred, TRUE);
+    g_hash_table_destroy(history->entries);
+    g_free(history);
+    catalog->history = NULL;
+}
+
+void launch_history_record(LauncherPlugin *launcher, const gchar *desktop_id) {
+    LaunchHistory *history = launcher->catalog->history;
+    gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+    gchar *line;
+    
+    if (!history || !desktop_id || strchr(desktop_id, '\n'))
+        return;
+    
+    add_launch(history, desktop_id, now);
+    line = g_strdup_printf("%" G_GINT64_FORMAT " %s\n", now, desktop_id);
+    
+    /* A compaction in flight would overwrite the line */
+    if (history->compacting)
+        g_string_append(history->deferred, line);
+    else
+        append_log(line);
+    g_free(line);
+    
+    if (++history->log_lines >= HISTORY_COMPACT_LINES)
+        compact_history(history);
+}
+
+/* Current frecency of desktop_id, 0 if it was never launched */
+gdouble launch_history_score(LauncherPlugin *launcher, const gchar *desktop_id) {
+    HistoryEntry *entry;
+    
+    if (!launcher->catalog->history || !desktop_id)
+        return 0.0;
+    
+    entry = g_hash_table_lookup(launcher->catalog->history->entries, desktop_id);
+    return entry ? decayed_score(entry, g_get_real_time() / G_USEC_PER_SEC) : 0.0;
+}
+
+typedef struct {
+    AppInfo *app;
+    gdouble score;
+} RankedApp;
+
+static gint compare_ranked(gconstpointer a, gconstpointer b) {
+    const RankedApp *ranked_a = a, *ranked_b = b;
+    
+    if (ranked_a->score != ranked_b->score)
+        return ranked_a->score < ranked_b->score ? 1 : -1;
+    return compare_app_names(ranked_a->app, ranked_b->app);
+}
+
+/* Up to max_apps visible applications with the highest frecency */
+GList* launch_history_top(LauncherPlugin *launcher, guint max_apps) {
+    GHashTableIter iter;
+    gpointer key, value;
+    GArray *ranked;
+    GList *list = NULL;
+    gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+    
+    if (!launcher->catalog->history || !launcher->catalog->app_index)
+        return NULL;
+    
+    ranked = g_array_new(FALSE, FALSE, sizeof(RankedApp));
+    g_hash_table_iter_init(&iter, launcher->catalog->history->entries);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        RankedApp item;
+        
+        item.app = g_hash_table_lookup(launcher->catalog->app_index, key);
+        if (!item.app || !item.app->name || item.app->is_hidden)
+            continue;
+        
+        item.score = decayed_score(value, now);
+        g_array_append_val(ranked, item);
+    }
+    
+    g_array_sort(ranked, compare_ranked);
+    for (guint i = MIN(ranked->len, max_apps); i > 0; i--)
+        list = g_list_prepend(list, g_array_index(ranked, RankedApp, i - 1).app);
+    
+    g_array_unref(ranked);
+    return list;
+}
@@ -0,0 +1,361 @@
+/*
+ * XFCE Launcher Plugin v0.7
+ *
+ * Changelog:
+ * - Hotkey setting to toggle the launcher (integrates with XFCE custom keyboard shortcuts)
+ * - Drag & drop improvements: reorder apps, create folders, add apps to folders
+ * - Search result highlighting (matched text in app names is highlighted)
+ * - Responsive layout: grid size, icon size, and spacing adapt to the current screen resolution
+ * - Settings dialog updated (includes hotkey configuration)
+ * - Configuration saving is more robust (XML attribute escaping)
+ * - Fixed broken drag-and-drop behavior
+ * - Fixed potential memory leak when loading configuration (folder id replacement)
+ * - Fixed callback type mismatches and reduced build warnings
+
+ * Persistent icon atlas
+ *
+ * Decoded icons are written to $XDG_CACHE_HOME as premultiplied ARGB32
+ * (RGB24 for icons without alpha) tiles, one file per icon size and
+ * scale. After a restart the icon cache wraps the mapped tiles in cairo
+ * surfaces instead of decoding the icons again. The atlas records the
+ * icon theme it was built with and the mtime of every icon file; an icon
+ * whose file changed is decoded as usual.
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <glib/gstdio.h>
+#include <string.h>
+
+#define ICON_ATLAS_MAGIC     0x41494c58  /* "XLIA" */
+#define ICON_ATLAS_VERSION   1
+#define ICON_ATLAS_ALIGNMENT 16
+
+/* On-disk layout: header, icon records sorted by name, string table,
+ * padding, pixel data. Record offsets into the pixel data are relative
+ * to pixels_offset and aligned to ICON_ATLAS_ALIGNMENT. */
+typedef struct {
+    guint32 magic;
+    guint32 version;
+    guint32 size;
+    guint32 scale;
+    guint32 theme;
+    guint32 n_icons;
+    guint32 strings_offset;
+    guint32 strings_size;
+    guint64 pixels_offset;
+    guint64 pixels_size;
+} AtlasHeader;
+
+typedef struct {
+    guint32 name;
+    guint32 filename;
+    gint64  mtime;          /* nanoseconds */
+    guint32 width;
+    guint32 height;
+    guint32 stride;
+    guint32 format;         /* cairo_format_t */
+    guint64 offset;
+} AtlasRecord;
+
+struct _IconAtlas {
+    GMappedFile *mapped;
+    const AtlasHeader *header;
+    const AtlasRecord *records;
+    const gchar *strings;
+    guchar *pixels;
+};
+
+gchar* icon_atlas_get_path(gint size, gint scale) {
+    gchar *basename = g_strdup_printf("icons-%d@%d.atlas", size, scale);
+    gchar *path = g_build_filename(g_get_user_cache_dir(), "xfce4", "launcher", basename, NULL);
+
+    g_free(basename);
+    return path;
+}
+
+gchar* icon_atlas_get_theme_name(void) {
+    gchar *theme_name = NULL;
+
+    g_object_get(gtk_settings_get_default(), "gtk-icon-theme-name", &theme_name, NULL);
+    return theme_name ? theme_name : g_strdup("hicolor");
+}
+
+static gint64 stat_mtime(const GStatBuf *st) {
+    return (gint64)st->st_mtim.tv_sec * G_GINT64_CONSTANT(1000000000) + st->st_mtim.tv_nsec;
+}
+
+/* Modification time of an icon file, -1 if it cannot be read */
+gint64 icon_atlas_file_mtime(const gchar *filename) {
+    GStatBuf st;
+
+    if (!filename || g_stat(filename, &st) != 0)
+        return -1;
+    return stat_mtime(&st);
+}
+
+static const gchar* atlas_string(IconAtlas *atlas, guint32 offset) {
+    if (offset >= atlas->header->strings_size)
+        return NULL;
+    return atlas->strings + offset;
+}
+
+/* Map the atlas for size and scale, NULL if it is missing, damaged or was
+ * built for another icon theme */
+IconAtlas* icon_atlas_open(gint size, gint scale, const gchar *theme_name) {
+    IconAtlas *atlas;
+    GMappedFile *mapped;
+    const AtlasHeader *header;
+    const gchar *contents;
+    gchar *path;
+    gsize length;
+
+    path = icon_atlas_get_path(size, scale);
+    /* Private and writable: cairo takes a non-const pointer to the pixels */
+    mapped = g_mapped_file_new(path, TRUE, NULL);
+    g_free(path);
+    if (!mapped)
+        return NULL;
+
+    contents = g_mapped_file_get_contents(mapped);
+    length = g_mapped_file_get_length(mapped);
+    header = (const AtlasHeader *)contents;
+
+    if (length < sizeof(AtlasHeader) ||
+        header->magic != ICON_ATLAS_MAGIC || header->version != ICON_ATLAS_VERSION ||
+        header->size != (guint32)size || header->scale != (guint32)scale ||
+        header->strings_offset != sizeof(AtlasHeader) + (gsize)header->n_icons * sizeof(AtlasRecord) ||
+        (gsize)header->strings_offset + header->strings_size > header->pixels_offset ||
+        header->pixels_offset % ICON_ATLAS_ALIGNMENT != 0 ||
+        header->pixels_offset + header->pixels_size != length ||
+        header->strings_size == 0 || contents[header->strings_offset + header->strings_size - 1] != '\0') {
+        g_mapped_file_unref(mapped);
+        return NULL;
+    }
+
+    atlas = g_new0(IconAtlas, 1);
+    atlas->mapped = mapped;
+    atlas->header = header;
+    atlas->records = (const AtlasRecord *)(contents + sizeof(AtlasHeader));
+    atlas->strings = contents + header->strings_offset;
+    atlas->pixels = (guchar *)contents + header->pixels_offset;
+
+    if (g_strcmp0(atlas_string(atlas, header->theme), theme_name) != 0) {
+        icon_atlas_free(atlas);
+        return NULL;
+    }
+
+    return atlas;
+}
+
+void icon_atlas_free(IconAtlas *atlas) {
+    if (!atlas)
+        return;
+
+    /* Surfaces handed out keep their own reference to the mapping */
+    g_mapped_file_unref(atlas->mapped);
+    g_free(atlas);
+}
+
+static const AtlasRecord* find_record(IconAtlas *atlas, const gchar *icon_name) {
+    guint32 low = 0, high = atlas->header->n_icons;
+
+    while (low < high) {
+        guint32 mid = low + (high - low) / 2;
+        const gchar *name = atlas_string(atlas, atlas->records[mid].name);
+        gint cmp = strcmp(icon_name, name ? name : "");
+
+        if (cmp == 0)
+            return &atlas->records[mid];
+        if (cmp < 0)
+            high = mid;
+        else
+            low = mid + 1;
+    }
+
+    return NULL;
+}
+
+/* Surface backed by the mapped tile of icon_name, or NULL if the atlas has
+ * no such icon or its file changed since. The caller owns the surface. */
+cairo_surface_t* icon_atlas_lookup(IconAtlas *atlas, const gchar *icon_name,
+                                   const gchar **filename, gint64 *mtime) {
+    const AtlasRecord *record;
+    cairo_surface_t *surface;
+    static cairo_user_data_key_t mapping_key;
+
+    if (!atlas || !icon_name)
+        return NULL;
+
+    record = find_record(atlas, icon_name);
+    if (!record ||
+        (record->format != CAIRO_FORMAT_ARGB32 && record->format != CAIRO_FORMAT_RGB24) ||
+        record->stride != (guint32)cairo_format_stride_for_width(record->format, record->width) ||
+        record->offset + (guint64)record->stride * record->height > atlas->header->pixels_size)
+        return NULL;
+
+    *filename = atlas_string(atlas, record->filename);
+    *mtime = icon_atlas_file_mtime(*filename);
+    if (*mtime != record->mtime)
+        return NULL;
+
+    surface = cairo_image_surface_create_for_data(atlas->pixels + record->offset, record->format,
+                                                  record->width, record->height, record->stride);
+    cairo_surface_set_device_scale(surface, atlas->header->scale, atlas->header->scale);
+    cairo_surface_set_user_data(surface, &mapping_key, g_mapped_file_ref(atlas->mapped),
+                                (cairo_destroy_func_t)g_mapped_file_unref);
+
+    return surface;
+}
+
+static gint compare_atlas_icons(gconstpointer a, gconstpointer b) {
+    const AtlasIcon *icon_a = *(const AtlasIcon * const *)a;
+    const AtlasIcon *icon_b = *(const AtlasIcon * const *)b;
+
+    return strcmp(icon_a->name, icon_b->name);
+}
+
+void atlas_icon_free(AtlasIcon *icon) {
+    g_free(icon->name);
+    g_free(icon->filename);
+    cairo_surface_destroy(icon->surface);
+    g_free(icon);
+}
+
+typedef struct {
+    gint size;
+    gint scale;
+    gchar *theme_name;
+    GPtrArray *icons;
+} AtlasSnapshot;
+
+static void atlas_snapshot_free(gpointer data) {
+    AtlasSnapshot *snapshot = (AtlasSnapshot *)data;
+
+    g_free(snapshot->theme_name);
+    g_ptr_array_unref(snapshot->icons);
+    g_free(snapshot);
+}
+
+/* Write the atlas for size and scale from icons, an array of AtlasIcon
+ * freed with atlas_icon_free() whose surfaces are ARGB32 or RGB24 image
+ * surfaces */
+void icon_atlas_save(gint size, gint scale, const gchar *theme_name, GPtrArray *icons) {
+    AtlasHeader header = { 0 };
+    GArray *records;
+    GByteArray *strings;
+    GByteArray *data;
+    gchar *path;
+    gchar *dir;
+    guint64 pixels_size = 0;
+    GError *error = NULL;
+
+    /* Sorted by name for the binary search, names are unique */
+    g_ptr_array_sort(icons, compare_atlas_icons);
+    for (guint i = 1; i < icons->len; ) {
+        AtlasIcon *icon = g_ptr_array_index(icons, i);
+
+        if (strcmp(icon->name, ((AtlasIcon *)g_ptr_array_index(icons, i - 1))->name) == 0)
+            g_ptr_array_remove_index(icons, i);
+        else
+            i++;
+    }
+
+    records = g_array_new(FALSE, FALSE, sizeof(AtlasRecord));
+    strings = g_byte_array_new();
+
+    header.magic = ICON_ATLAS_MAGIC;
+    header.version = ICON_ATLAS_VERSION;
+    header.size = size;
+    header.scale = scale;
+    header.theme = strings->len;
+    g_byte_array_append(strings, (const guint8 *)theme_name, strlen(theme_name) + 1);
+
+    for (guint i = 0; i < icons->len; i++) {
+        AtlasIcon *icon = g_ptr_array_index(icons, i);
+        AtlasRecord record = { 0 };
+
+        record.name = strings->len;
+        g_byte_array_append(strings, (const guint8 *)icon->name, strlen(icon->name) + 1);
+        record.filename = strings->len;
+        g_byte_array_append(strings, (const guint8 *)icon->filename, strlen(icon->filename) + 1);
+        record.mtime = icon->mtime;
+        record.width = cairo_image_surface_get_width(icon->surface);
+        record.height = cairo_image_surface_get_height(icon->surface);
+        record.stride = cairo_image_surface_get_stride(icon->surface);
+        record.format = cairo_image_surface_get_format(icon->surface);
+        record.offset = pixels_size;
+        pixels_size += (guint64)record.stride * record.height;
+        pixels_size = (pixels_size + ICON_ATLAS_ALIGNMENT - 1) / ICON_ATLAS_ALIGNMENT * ICON_ATLAS_ALIGNMENT;
+        g_array_append_val(records, record);
+    }
+
+    header.n_icons = records->len;
+    header.strings_offset = sizeof(AtlasHeader) + records->len * sizeof(AtlasRecord);
+    header.strings_size = strings->len;
+    header.pixels_offset = (header.strings_offset + header.strings_size + ICON_ATLAS_ALIGNMENT - 1) /
+                           ICON_ATLAS_ALIGNMENT * ICON_ATLAS_ALIGNMENT;
+    header.pixels_size = pixels_size;
+
+    data = g_byte_array_sized_new(header.pixels_offset + header.pixels_size);
+    g_byte_array_append(data, (const guint8 *)&header, sizeof(AtlasHeader));
+    g_byte_array_append(data, (const guint8 *)records->data, records->len * sizeof(AtlasRecord));
+    g_byte_array_append(data, strings->data, strings->len);
+    g_byte_array_set_size(data, header.pixels_offset + header.pixels_size);
+    memset(data->data + header.strings_offset + header.strings_size, 0,
+           data->len - header.strings_offset - header.strings_size);
+
+    for (guint i = 0; i < icons->len; i++) {
+        AtlasIcon *icon = g_ptr_array_index(icons, i);
+        AtlasRecord *record = &g_array_index(records, AtlasRecord, i);
+
+        cairo_surface_flush(icon->surface);
+        memcpy(data->data + header.pixels_offset + record->offset,
+               cairo_image_surface_get_data(icon->surface),
+               (gsize)record->stride * record->height);
+    }
+
+    path = icon_atlas_get_path(size, scale);
+    dir = g_path_get_dirname(path);
+    g_mkdir_with_parents(dir, 0700);
+
+    if (!g_file_set_contents(path, (const gchar *)data->data, data->len, &error)) {
+        g_warning("Failed to write icon atlas: %s", error->message);
+        g_error_free(error);
+    }
+
+    g_free(dir);
+    g_free(path);
+    g_byte_array_free(data, TRUE);
+    g_byte_array_free(strings, TRUE);
+    g_array_free(records, TRUE);
+}
+
+static void icon_atlas_save_thread(GTask *task,
+                                   gpointer source_object,
+                                   gpointer task_data,
+                                   GCancellable *cancellable) {
+    AtlasSnapshot *snapshot = (AtlasSnapshot *)task_data;
+
+    icon_atlas_save(snapshot->size, snapshot->scale, snapshot->theme_name, snapshot->icons);
+    g_task_return_boolean(task, TRUE);
+}
+
+/* Write the atlas from a worker thread, takes ownership of icons */
+void icon_atlas_save_async(gint size, gint scale, const gchar *theme_name, GPtrArray *icons) {
+    AtlasSnapshot *snapshot = g_new0(AtlasSnapshot, 1);
+    GTask *task;
+
+    snapshot->size = size;
+    snapshot->scale = scale;
+    snapshot->theme_name = g_strdup(theme_name);
+    snapshot->icons = icons;
+
+    task = g_task_new(NULL, NULL, NULL, NULL);
+    g_task_set_task_data(task, snapshot, atlas_snapshot_free);
+    g_task_run_in_thread(task, icon_atlas_save_thread);
+    g_object_unref(task);
+}
@@ -0,0 +1,496 @@
+/*
+ * XFCE Launcher Plugin v0.7
+ *
+ * Changelog:
+ * - Hotkey setting to toggle the launcher (integrates with XFCE custom keyboard shortcuts)
+ * - Drag & drop improvements: reorder apps, create folders, add apps to folders
+ * - Search result highlighting (matched text in app names is highlighted)
+ * - Responsive layout: grid size, icon size, and spacing adapt to the current screen resolution
+ * - Settings dialog updated (includes hotkey configuration)
+ * - Configuration saving is more robust (XML attribute escaping)
+ * - Fixed broken drag-and-drop behavior
+ * - Fixed potential memory leak when loading configuration (folder id replacement)
+ * - Fixed callback type mismatches and reduced build warnings
+
+ * Icon surface cache
+ *
+ * Application and folder icons are resolved and decoded once per icon
+ * name, pixel size and scale, and kept as cairo surfaces within a memory
+ * budget (least recently used first out). After a load the icons of all
+ * applications are decoded ahead of time through GTK's asynchronous icon
+ * loading; tiles that bind an icon not loaded yet decode it synchronously.
+ * Icons at the size the tiles use are first looked up in the persistent
+ * icon atlas for that size and scale, which is rewritten once a preload
+ * had to decode anything.
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <string.h>
+
+#define ICON_CACHE_BUDGET (16 * 1024 * 1024)
+#define ICON_PRELOAD_IN_FLIGHT 4
+
+typedef struct {
+    gchar *name;
+    gint size;
+    gint scale;
+} IconKey;
+
+typedef struct {
+    IconKey key;
+    cairo_surface_t *surface;   /* NULL if the theme has no such icon */
+    gchar *filename;            /* icon file, NULL for built-in icons */
+    gint64 mtime;
+    gsize bytes;
+    GList *lru;                 /* link in cache->lru, NULL while loading */
+    gboolean loading;
+} IconEntry;
+
+struct _IconCache {
+    Catalog *catalog;
+    GtkIconTheme *theme;
+    GHashTable *entries;        /* IconKey -> IconEntry, keys owned by the entries */
+    GQueue lru;                 /* IconEntry, most recently used first */
+    gsize bytes;
+    GCancellable *cancellable;
+    
+    /* Persistent atlas for atlas_size at atlas_scale, reopened when the
+     * tiles ask for another size or scale */
+    IconAtlas *atlas;
+    gchar *theme_name;
+    gint atlas_size;
+    gint atlas_scale;
+    gboolean atlas_stale;
+    
+    /* Ahead-of-time decoding */
+    GQueue preload;             /* icon names */
+    gint preload_size;
+    gint preload_scale;
+    guint preload_id;
+    guint in_flight;
+    
+    guint hits;
+    guint misses;
+};
+
+static guint icon_key_hash(gconstpointer data) {
+    const IconKey *key = data;
+    
+    return g_str_hash(key->name) ^ (key->size * 31) ^ (key->scale << 16);
+}
+
+static gboolean icon_key_equal(gconstpointer a, gconstpointer b) {
+    const IconKey *key_a = a, *key_b = b;
+    
+    return key_a->size == key_b->size && key_a->scale == key_b->scale &&
+           strcmp(key_a->name, key_b->name) == 0;
+}
+
+static void icon_key_free(IconKey *key) {
+    g_free(key->name);
+    g_free(key);
+}
+
+static void icon_entry_free(IconEntry *entry) {
+    if (entry->surface)
+        cairo_surface_destroy(entry->surface);
+    g_free(entry->filename);
+    g_free(entry->key.name);
+    g_free(entry);
+}
+
+static void evict_entry(IconCache *cache, IconEntry *entry) {
+    g_queue_delete_link(&cache->lru, entry->lru);
+    cache->bytes -= entry->bytes;
+    g_hash_table_remove(cache->entries, &entry->key);
+}
+
+/* Account for a finished entry and keep the cache within budget,
+ * takes ownership of surface */
+static void store_entry(IconCache *cache, IconEntry *entry, cairo_surface_t *surface) {
+    entry->loading = FALSE;
+    entry->surface = surface;
+    entry->bytes = sizeof(IconEntry) + strlen(entry->key.name);
+    
+    if (surface) {
+        entry->bytes += cairo_image_surface_get_stride(surface) *
+                        cairo_image_surface_get_height(surface);
+    }
+    
+    g_queue_push_head(&cache->lru, entry);
+    entry->lru = cache->lru.head;
+    cache->bytes += entry->bytes;
+    
+    while (cache->bytes > ICON_CACHE_BUDGET && cache->lru.tail->data != entry)
+        evict_entry(cache, cache->lru.tail->data);
+}
+
+/* Store a freshly decoded icon; the atlas needs rewriting to include it */
+static void store_decoded(IconCache *cache, IconEntry *entry, GdkPixbuf *pixbuf) {
+    cairo_surface_t *surface = NULL;
+    
+    if (pixbuf)
+        surface = gdk_cairo_surface_create_from_pixbuf(pixbuf, entry->key.scale, NULL);
+    if (surface && entry->filename && entry->key.size == cache->atlas_size)
+        cache->atlas_stale = TRUE;
+    
+    store_entry(cache, entry, surface);
+}
+
+static void remember_file(IconEntry *entry, GtkIconInfo *info) {
+    g_free(entry->filename);
+    entry->filename = g_strdup(gtk_icon_info_get_filename(info));
+    entry->mtime = icon_atlas_file_mtime(entry->filename);
+}
+
+/* Serve entry from the mapped atlas, if it has an up to date tile */
+static gboolean load_from_atlas(IconCache *cache, IconEntry *entry) {
+    cairo_surface_t *surface;
+    const gchar *filename = NULL;
+    gint64 mtime = -1;
+    
+    if (cache->atlas_size != entry->key.size || cache->atlas_scale != entry->key.scale) {
+        icon_atlas_free(cache->atlas);
+        cache->atlas = icon_atlas_open(entry->key.size, entry->key.scale, cache->theme_name);
+        cache->atlas_size = entry->key.size;
+        cache->atlas_scale = entry->key.scale;
+        cache->atlas_stale = FALSE;
+    }
+    
+    surface = icon_atlas_lookup(cache->atlas, entry->key.name, &filename, &mtime);
+    if (!surface)
+        return FALSE;
+    
+    entry->filename = g_strdup(filename);
+    entry->mtime = mtime;
+    store_entry(cache, entry, surface);
+    return TRUE;
+}
+
+static GtkIconInfo* lookup_icon(IconCache *cache, const IconKey *key) {
+    GtkIconInfo *info;
+    
+    /* Desktop files may name an image file instead of a theme icon */
+    if (g_path_is_absolute(key->name)) {
+        GFile *file = g_file_new_for_path(key->name);
+        GIcon *icon = g_file_icon_new(file);
+        
+        info = gtk_icon_theme_lookup_by_gicon_for_scale(cache->theme, icon, key->size, key->scale,
+                                                        GTK_ICON_LOOKUP_FORCE_SIZE);
+        g_object_unref(icon);
+        g_object_unref(file);
+    } else {
+        info = gtk_icon_theme_lookup_icon_for_scale(cache->theme, key->name, key->size, key->scale,
+                                                    GTK_ICON_LOOKUP_FORCE_SIZE);
+    }
+    
+    return info;
+}
+
+/* Callback data of an asynchronous load, which must not hold the entry */
+static IconKey* icon_key_copy(const IconKey *key) {
+    IconKey *copy = g_new(IconKey, 1);
+    
+    copy->name = g_strdup(key->name);
+    copy->size = key->size;
+    copy->scale = key->scale;
+    
+    return copy;
+}
+
+static IconEntry* icon_entry_new(const IconKey *key) {
+    IconEntry *entry = g_new0(IconEntry, 1);
+    
+    entry->key.name = g_strdup(key->name);
+    entry->key.size = key->size;
+    entry->key.scale = key->scale;
+    
+    return entry;
+}
+
+/* Surface for the icon, decoding it now if it is not cached yet.
+ * Returns NULL if the icon cannot be found. The cache owns the result. */
+cairo_surface_t* icon_cache_lookup(LauncherPlugin *launcher, const gchar *icon_name,
+                                   gint size, gint scale) {
+    IconCache *cache = launcher->catalog->icon_cache;
+    IconKey key = { (gchar *)icon_name, size, scale };
+    IconEntry *entry;
+    GtkIconInfo *info;
+    GdkPixbuf *pixbuf = NULL;
+    
+    if (!cache || !icon_name)
+        return NULL;
+    
+    entry = g_hash_table_lookup(cache->entries, &key);
+    if (entry && !entry->loading) {
+        cache->hits++;
+        g_queue_unlink(&cache->lru, entry->lru);
+        g_queue_push_head_link(&cache->lru, entry->lru);
+        return entry->surface;
+    }
+    
+    /* Not decoded yet, or the background load has not finished */
+    cache->misses++;
+    if (!entry) {
+        entry = icon_entry_new(&key);
+        g_hash_table_insert(cache->entries, &entry->key, entry);
+    }
+    
+    if (load_from_atlas(cache, entry))
+        return entry->surface;
+    
+    info = lookup_icon(cache, &key);
+    if (info) {
+        remember_file(entry, info);
+        pixbuf = gtk_icon_info_load_icon(info, NULL);
+        g_object_unref(info);
+    }
+    store_decoded(cache, entry, pixbuf);
+    if (pixbuf)
+        g_object_unref(pixbuf);
+    
+    return entry->surface;
+}
+
+static gboolean preload_icons(gpointer data);
+
+static void preload_finished(IconCache *cache) {
+    g_debug("Icon cache: %u entries, %" G_GSIZE_FORMAT " KiB, %u hits, %u misses",
+            g_hash_table_size(cache->entries), cache->bytes / 1024,
+            cache->hits, cache->misses);
+    
+    if (cache->atlas_stale)
+        icon_cache_write_atlas(cache->catalog, TRUE);
+}
+
+static void on_icon_loaded(GObject *source, GAsyncResult *result, gpointer data) {
+    IconKey *key = (IconKey *)data;
+    GError *error = NULL;
+    GdkPixbuf *pixbuf = gtk_icon_info_load_icon_finish(GTK_ICON_INFO(source), result, &error);
+    IconCache *cache;
+    IconEntry *entry;
+    
+    /* The cache is gone once the load is cancelled */
+    if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        g_error_free(error);
+        icon_key_free(key);
+        return;
+    }
+    
+    cache = (IconCache *)g_object_get_data(source, "icon-cache");
+    cache->in_flight--;
+    
+    /* A tile may have needed it first, and the entry it decoded may
+     * have been evicted since */
+    entry = g_hash_table_lookup(cache->entries, key);
+    if (entry && entry->loading)
+        store_decoded(cache, entry, pixbuf);
+    icon_key_free(key);
+    
+    if (error)
+        g_error_free(error);
+    if (pixbuf)
+        g_object_unref(pixbuf);
+    
+    if (cache->preload_id == 0 && !g_queue_is_empty(&cache->preload))
+        cache->preload_id = g_idle_add_full(G_PRIORITY_LOW, preload_icons, cache, NULL);
+    else if (cache->in_flight == 0 && g_queue_is_empty(&cache->preload))
+        preload_finished(cache);
+}
+
+/* Start background decodes of queued icons, a few at a time */
+static gboolean preload_icons(gpointer data) {
+    IconCache *cache = (IconCache *)data;
+    
+    while (cache->in_flight < ICON_PRELOAD_IN_FLIGHT && !g_queue_is_empty(&cache->preload)) {
+        gchar *name = g_queue_pop_head(&cache->preload);
+        IconKey key = { name, cache->preload_size, cache->preload_scale };
+        IconEntry *entry;
+        GtkIconInfo *info;
+        
+        /* Stop short of evicting what was preloaded first */
+        if (cache->bytes >= ICON_CACHE_BUDGET / 4 * 3) {
+            g_free(name);
+            g_queue_foreach(&cache->preload, (GFunc)g_free, NULL);
+            g_queue_clear(&cache->preload);
+            break;
+        }
+        
+        if (g_hash_table_contains(cache->entries, &key)) {
+            g_free(name);
+            continue;
+        }
+        
+        entry = icon_entry_new(&key);
+        g_hash_table_insert(cache->entries, &entry->key, entry);
+        g_free(name);
+        
+        if (load_from_atlas(cache, entry))
+            continue;
+        
+        info = lookup_icon(cache, &entry->key);
+        if (!info) {
+            store_entry(cache, entry, NULL);
+            continue;
+        }
+        
+        remember_file(entry, info);
+        entry->loading = TRUE;
+        cache->in_flight++;
+        g_object_set_data(G_OBJECT(info), "icon-cache", cache);
+        gtk_icon_info_load_icon_async(info, cache->cancellable, on_icon_loaded,
+                                      icon_key_copy(&entry->key));
+        g_object_unref(info);
+    }
+    
+    cache->preload_id = 0;
+    if (g_queue_is_empty(&cache->preload) && cache->in_flight == 0)
+        preload_finished(cache);
+    
+    return G_SOURCE_REMOVE;
+}
+
+/* Write the decoded icons of the current atlas size and scale to it */
+void icon_cache_write_atlas(Catalog *catalog, gboolean async) {
+    IconCache *cache = catalog->icon_cache;
+    GPtrArray *icons;
+    GList *iter;
+    
+    if (!cache || cache->atlas_scale == 0)
+        return;
+    
+    icons = g_ptr_array_new_with_free_func((GDestroyNotify)atlas_icon_free);
+    for (iter = cache->lru.head; iter != NULL; iter = iter->next) {
+        IconEntry *entry = iter->data;
+        AtlasIcon *icon;
+        
+        if (!entry->surface || !entry->filename || entry->mtime < 0 ||
+            entry->key.size != cache->atlas_size || entry->key.scale != cache->atlas_scale)
+            continue;
+        
+        icon = g_new0(AtlasIcon, 1);
+        icon->name = g_strdup(entry->key.name);
+        icon->filename = g_strdup(entry->filename);
+        icon->mtime = entry->mtime;
+        icon->surface = cairo_surface_reference(entry->surface);
+        g_ptr_array_add(icons, icon);
+    }
+    
+    if (async)
+        icon_atlas_save_async(cache->atlas_size, cache->atlas_scale, cache->theme_name, icons);
+    else {
+        icon_atlas_save(cache->atlas_size, cache->atlas_scale, cache->theme_name, icons);
+        g_ptr_array_unref(icons);
+    }
+    cache->atlas_stale = FALSE;
+}
+
+/* Decode the icons of apps in the background, first pages first */
+void icon_cache_preload(LauncherPlugin *launcher, GPtrArray *apps) {
+    IconCache *cache = launcher->catalog->icon_cache;
+    const GridGeometry *geometry;
+    GHashTable *queued;
+    
+    if (!cache)
+        return;
+    
+    queued = g_hash_table_new(NULL, NULL);
+    g_queue_foreach(&cache->preload, (GFunc)g_free, NULL);
+    g_queue_clear(&cache->preload);
+    
+    /* At the size the overlay will use on the monitor of the button */
+    geometry = grid_geometry_for_view(launcher, NULL);
+    cache->preload_size = geometry->icon_size;
+    cache->preload_scale = geometry->scale;
+    
+    for (guint i = 0; i < apps->len; i++) {
+        AppInfo *app = g_ptr_array_index(apps, i);
+        
+        /* Interned, so equal names are the same pointer */
+        if (app->icon && !app->is_hidden && g_hash_table_add(queued, (gpointer)app->icon))
+            g_queue_push_tail(&cache->preload, g_strdup(app->icon));
+    }
+    g_queue_push_tail(&cache->preload, g_strdup("application-x-executable"));
+    g_hash_table_destroy(queued);
+    
+    if (cache->preload_id == 0)
+        cache->preload_id = g_idle_add_full(G_PRIORITY_LOW, preload_icons, cache, NULL);
+}
+
+static void icon_cache_clear(IconCache *cache) {
+    if (cache->preload_id) {
+        g_source_remove(cache->preload_id);
+        cache->preload_id = 0;
+    }
+    
+    /* Pending loads drop their results */
+    g_cancellable_cancel(cache->cancellable);
+    g_object_unref(cache->cancellable);
+    cache->cancellable = g_cancellable_new();
+    cache->in_flight = 0;
+    
+    g_queue_foreach(&cache->preload, (GFunc)g_free, NULL);
+    g_queue_clear(&cache->preload);
+    g_queue_clear(&cache->lru);
+    g_hash_table_remove_all(cache->entries);
+    cache->bytes = 0;
+    
+    /* Reopened on the next lookup */
+    g_clear_pointer(&cache->atlas, icon_atlas_free);
+    cache->atlas_size = 0;
+    cache->atlas_scale = 0;
+    cache->atlas_stale = FALSE;
+}
+
+static void on_icon_theme_changed(GtkIconTheme *theme, Catalog *catalog) {
+    IconCache *cache = catalog->icon_cache;
+    GList *iter;
+    
+    icon_cache_clear(cache);
+    g_free(cache->theme_name);
+    cache->theme_name = icon_atlas_get_theme_name();
+    
+    /* Tiles hold surfaces of the old theme */
+    for (iter = catalog->views; iter != NULL; iter = g_list_next(iter)) {
+        LauncherPlugin *launcher = (LauncherPlugin *)iter->data;
+        
+        if (launcher->overlay_window && gtk_widget_get_visible(launcher->overlay_window))
+            populate_current_page(launcher);
+    }
+    icon_cache_preload(catalog_get_primary_view(catalog), catalog->apps);
+}
+
+void icon_cache_new(Catalog *catalog) {
+    IconCache *cache = g_new0(IconCache, 1);
+    
+    cache->catalog = catalog;
+    cache->theme = gtk_icon_theme_get_default();
+    cache->entries = g_hash_table_new_full(icon_key_hash, icon_key_equal, NULL,
+                                           (GDestroyNotify)icon_entry_free);
+    cache->cancellable = g_cancellable_new();
+    cache->theme_name = icon_atlas_get_theme_name();
+    g_queue_init(&cache->lru);
+    g_queue_init(&cache->preload);
+    catalog->icon_cache = cache;
+    
+    g_signal_connect(cache->theme, "changed", G_CALLBACK(on_icon_theme_changed), catalog);
+}
+
+void icon_cache_free(Catalog *catalog) {
+    IconCache *cache = catalog->icon_cache;
+    
+    if (!cache)
+        return;
+    
+    g_signal_handlers_disconnect_by_data(cache->theme, catalog);
+    icon_cache_clear(cache);
+    g_object_unref(cache->cancellable);
+    g_hash_table_destroy(cache->entries);
+    g_free(cache->theme_name);
+    g_free(cache);
+    catalog->icon_cache = NULL;
+}
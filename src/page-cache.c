@@ -0,0 +1,367 @@
+/*
+ * XFCE Launcher Plugin v0.7
+ *
+ * Changelog:
+ * - Hotkey setting to toggle the launcher (integrates with XFCE custom keyboard shortcuts)
+ * - Drag & drop improvements: reorder apps, create folders, add apps to folders
+ * - Search result highlighting (matched text in app names is highlighted)
+ * - Responsive layout: grid size, icon size, and spacing adapt to the current screen resolution
+ * - Settings dialog updated (includes hotkey configuration)
+ * - Configuration saving is more robust (XML attribute escaping)
+ * - Fixed broken drag-and-drop behavior
+ * - Fixed potential memory leak when loading configuration (folder id replacement)
+ * - Fixed callback type mismatches and reduced build warnings
+
+ * Page surface cache and page transitions
+ *
+ * The current page and its neighbours are rendered during idle time into
+ * image surfaces by a second, off-screen grid. Each surface remembers which
+ * entries it shows; a page change with both pages cached slides the
+ * surfaces while the live tiles are rebound underneath.
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+
+#define PAGE_CACHE_SIZE 5
+#define PAGE_TRANSITION_MS 180
+
+typedef struct {
+    gint page;
+    guint64 signature;
+    cairo_surface_t *surface;
+} PageSurface;
+
+struct _PageCache {
+    LauncherPlugin *launcher;
+    
+    /* Off-screen renderer */
+    GtkWidget *window;
+    GtkWidget *grid;
+    GPtrArray *app_tiles;
+    GPtrArray *folder_tiles;
+    guint render_id;
+    guint serial;
+    
+    GQueue entries;             /* PageSurface, most recently used first */
+    
+    /* Running transition */
+    GtkWidget *transition;
+    cairo_surface_t *from;
+    cairo_surface_t *to;
+    gint direction;
+    gint64 start_time;
+    gdouble progress;
+    guint tick_id;
+};
+
+static void page_surface_free(PageSurface *entry) {
+    cairo_surface_destroy(entry->surface);
+    g_free(entry);
+}
+
+static guint64 mix_signature(guint64 hash, gconstpointer pointer) {
+    /* FNV-1a over the pointer value */
+    guint64 value = (guint64)GPOINTER_TO_SIZE(pointer);
+    
+    for (gint i = 0; i < 8; i++) {
+        hash ^= (value >> (i * 8)) & 0xff;
+        hash *= 1099511628211ULL;
+    }
+    
+    return hash;
+}
+
+/* Identifies the entries shown on page, see populate_grid() */
+static guint64 page_signature(LauncherPlugin *launcher, gint page) {
+    PageCache *cache = launcher->page_cache;
+    guint64 hash = 14695981039346656037ULL ^ cache->serial;
+    gint apps_per_page = launcher->geometry.apps_per_page;
+    gint start_index = page * apps_per_page;
+    gint n_folders = 0;
+    GPtrArray *apps;
+    GList *iter;
+    
+    hash = mix_signature(hash, launcher->open_folder);
+    
+    for (iter = launcher->catalog->folder_list; iter != NULL; iter = g_list_next(iter)) {
+        hash = mix_signature(hash, iter->data);
+        n_folders++;
+    }
+    
+    /* Same slice as populate_grid() */
+    apps = launcher->open_folder ? launcher->open_folder->apps : launcher->filtered;
+    for (gint i = MAX(start_index - n_folders, 0);
+         i < start_index + apps_per_page - n_folders && i < (gint)apps->len; i++)
+        hash = mix_signature(hash, g_ptr_array_index(apps, i));
+    
+    return hash;
+}
+
+/* Cached surface for page if it still shows the current entries */
+static cairo_surface_t* lookup_page(LauncherPlugin *launcher, gint page) {
+    PageCache *cache = launcher->page_cache;
+    GList *link;
+    
+    for (link = cache->entries.head; link != NULL; link = link->next) {
+        PageSurface *entry = link->data;
+        
+        if (entry->page != page)
+            continue;
+        if (entry->signature != page_signature(launcher, page))
+            return NULL;
+        
+        g_queue_unlink(&cache->entries, link);
+        g_queue_push_head_link(&cache->entries, link);
+        return entry->surface;
+    }
+    
+    return NULL;
+}
+
+static void render_page(LauncherPlugin *launcher, gint page) {
+    PageCache *cache = launcher->page_cache;
+    PageSurface *entry;
+    GtkRequisition size;
+    GtkAllocation allocation = { 0, };
+    cairo_t *cr;
+    GList *link;
+    
+    populate_grid(launcher, cache->grid, cache->app_tiles, cache->folder_tiles, page);
+    
+    /* Lay the grid out right away instead of waiting for a frame */
+    gtk_widget_get_preferred_size(cache->grid, NULL, &size);
+    if (size.width <= 0 || size.height <= 0)
+        return;
+    allocation.width = size.width;
+    allocation.height = size.height;
+    gtk_widget_size_allocate(cache->grid, &allocation);
+    
+    /* Replace an outdated surface of the same page */
+    for (link = cache->entries.head; link != NULL; link = link->next) {
+        if (((PageSurface *)link->data)->page == page) {
+            page_surface_free(link->data);
+            g_queue_delete_link(&cache->entries, link);
+            break;
+        }
+    }
+    
+    entry = g_new0(PageSurface, 1);
+    entry->page = page;
+    entry->signature = page_signature(launcher, page);
+    entry->surface = gdk_window_create_similar_image_surface(gtk_widget_get_window(cache->window),
+                                                             CAIRO_FORMAT_ARGB32,
+                                                             size.width, size.height, 0);
+    cr = cairo_create(entry->surface);
+    gtk_widget_draw(cache->grid, cr);
+    cairo_destroy(cr);
+    
+    g_queue_push_head(&cache->entries, entry);
+    while (g_queue_get_length(&cache->entries) > PAGE_CACHE_SIZE)
+        page_surface_free(g_queue_pop_tail(&cache->entries));
+}
+
+/* Render one missing page per idle run, nearest to the current page first */
+static gboolean prerender_pages(gpointer data) {
+    LauncherPlugin *launcher = (LauncherPlugin *)data;
+    PageCache *cache = launcher->page_cache;
+    gint candidates[3] = {
+        launcher->current_page,
+        launcher->current_page + 1,
+        launcher->current_page - 1
+    };
+    
+    /* An open folder is a single page */
+    if (!launcher->open_folder) {
+        for (gint i = 0; i < 3; i++) {
+            gint page = candidates[i];
+            
+            if (page < 0 || page >= MAX(launcher->total_pages, 1))
+                continue;
+            if (lookup_page(launcher, page))
+                continue;
+            
+            render_page(launcher, page);
+            return G_SOURCE_CONTINUE;
+        }
+    }
+    
+    cache->render_id = 0;
+    return G_SOURCE_REMOVE;
+}
+
+void page_cache_prerender(LauncherPlugin *launcher) {
+    PageCache *cache = launcher->page_cache;
+    
+    if (cache && cache->render_id == 0)
+        cache->render_id = g_idle_add_full(G_PRIORITY_LOW, prerender_pages, launcher, NULL);
+}
+
+void page_cache_invalidate(LauncherPlugin *launcher) {
+    PageCache *cache = launcher->page_cache;
+    
+    if (!cache)
+        return;
+    
+    /* Entries of the old serial no longer match any page */
+    cache->serial++;
+    g_queue_foreach(&cache->entries, (GFunc)page_surface_free, NULL);
+    g_queue_clear(&cache->entries);
+}
+
+static void draw_page_surface(cairo_t *cr, cairo_surface_t *surface,
+                              gint width, gint height, gdouble offset) {
+    gdouble scale_x, scale_y;
+    gdouble surface_width, surface_height;
+    
+    /* Centered like the grid in its box */
+    cairo_surface_get_device_scale(surface, &scale_x, &scale_y);
+    surface_width = cairo_image_surface_get_width(surface) / scale_x;
+    surface_height = cairo_image_surface_get_height(surface) / scale_y;
+    
+    cairo_set_source_surface(cr, surface,
+                             (gint)((width - surface_width) / 2 + offset),
+                             (gint)((height - surface_height) / 2));
+    cairo_paint(cr);
+}
+
+static gboolean on_transition_draw(GtkWidget *widget, cairo_t *cr, PageCache *cache) {
+    gint width = gtk_widget_get_allocated_width(widget);
+    gint height = gtk_widget_get_allocated_height(widget);
+    gdouble t = 1.0 - (1.0 - cache->progress) * (1.0 - cache->progress) * (1.0 - cache->progress);
+    
+    if (!cache->from || !cache->to)
+        return FALSE;
+    
+    draw_page_surface(cr, cache->from, width, height, -cache->direction * t * width);
+    draw_page_surface(cr, cache->to, width, height, cache->direction * (1.0 - t) * width);
+    
+    return TRUE;
+}
+
+static void finish_transition(PageCache *cache) {
+    LauncherPlugin *launcher = cache->launcher;
+    
+    if (cache->tick_id) {
+        gtk_widget_remove_tick_callback(cache->transition, cache->tick_id);
+        cache->tick_id = 0;
+    }
+    
+    g_clear_pointer(&cache->from, cairo_surface_destroy);
+    g_clear_pointer(&cache->to, cairo_surface_destroy);
+    gtk_widget_hide(cache->transition);
+    gtk_widget_set_opacity(gtk_bin_get_child(GTK_BIN(launcher->grid_area)), 1.0);
+}
+
+static gboolean on_transition_tick(GtkWidget *widget, GdkFrameClock *clock, gpointer data) {
+    PageCache *cache = (PageCache *)data;
+    gint64 now = gdk_frame_clock_get_frame_time(clock);
+    
+    if (cache->start_time == 0)
+        cache->start_time = now;
+    cache->progress = MIN(1.0, (now - cache->start_time) / (PAGE_TRANSITION_MS * 1000.0));
+    gtk_widget_queue_draw(widget);
+    
+    if (cache->progress >= 1.0) {
+        cache->tick_id = 0;
+        finish_transition(cache);
+        return G_SOURCE_REMOVE;
+    }
+    
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean animations_enabled(GtkWidget *widget) {
+    gboolean enabled = TRUE;
+    
+    g_object_get(gtk_widget_get_settings(widget), "gtk-enable-animations", &enabled, NULL);
+    return enabled;
+}
+
+/* Switch to page, sliding between cached surfaces when both are available */
+void show_page(LauncherPlugin *launcher, gint page) {
+    PageCache *cache = launcher->page_cache;
+    gint old_page = launcher->current_page;
+    
+    if (cache) {
+        cairo_surface_t *from, *to;
+        
+        finish_transition(cache);
+        
+        from = lookup_page(launcher, old_page);
+        to = lookup_page(launcher, page);
+        if (from && to && page != old_page &&
+            gtk_widget_get_mapped(launcher->grid_area) &&
+            animations_enabled(launcher->grid_area)) {
+            cache->from = cairo_surface_reference(from);
+            cache->to = cairo_surface_reference(to);
+            cache->direction = page > old_page ? 1 : -1;
+            cache->start_time = 0;
+            cache->progress = 0.0;
+            
+            /* The live tiles are rebound below while hidden */
+            gtk_widget_set_opacity(gtk_bin_get_child(GTK_BIN(launcher->grid_area)), 0.0);
+            gtk_widget_show(cache->transition);
+            cache->tick_id = gtk_widget_add_tick_callback(cache->transition, on_transition_tick,
+                                                          cache, NULL);
+        }
+    }
+    
+    launcher->current_page = page;
+    populate_current_page(launcher);
+    update_page_dots(launcher);
+    page_cache_prerender(launcher);
+}
+
+void page_cache_new(LauncherPlugin *launcher) {
+    PageCache *cache = g_new0(PageCache, 1);
+    
+    cache->launcher = launcher;
+    g_queue_init(&cache->entries);
+    launcher->page_cache = cache;
+    
+    /* Drawn above the grid while a transition runs, and takes its input */
+    cache->transition = gtk_drawing_area_new();
+    gtk_widget_set_no_show_all(cache->transition, TRUE);
+    g_signal_connect(cache->transition, "draw", G_CALLBACK(on_transition_draw), cache);
+    /* Hiding the overlay mid-transition stops the tick callback */
+    g_signal_connect_swapped(cache->transition, "unmap", G_CALLBACK(finish_transition), cache);
+    gtk_overlay_add_overlay(GTK_OVERLAY(launcher->grid_area), cache->transition);
+    
+    /* Same spacing as the live grid in create_overlay_window() */
+    cache->window = gtk_offscreen_window_new();
+    cache->grid = gtk_grid_new();
+    gtk_grid_set_row_spacing(GTK_GRID(cache->grid), launcher->geometry.spacing);
+    gtk_grid_set_column_spacing(GTK_GRID(cache->grid), launcher->geometry.spacing);
+    gtk_container_add(GTK_CONTAINER(cache->window), cache->grid);
+    create_tile_pool(launcher, cache->grid, &cache->app_tiles, &cache->folder_tiles);
+    gtk_widget_show(cache->grid);
+    gtk_widget_show(cache->window);
+    
+    /* Surfaces hold the icons of the old theme */
+    g_signal_connect_swapped(gtk_icon_theme_get_default(), "changed",
+                             G_CALLBACK(page_cache_invalidate), launcher);
+}
+
+void page_cache_free(LauncherPlugin *launcher) {
+    PageCache *cache = launcher->page_cache;
+    
+    if (!cache)
+        return;
+    
+    g_signal_handlers_disconnect_by_data(gtk_icon_theme_get_default(), launcher);
+    if (cache->render_id)
+        g_source_remove(cache->render_id);
+    finish_transition(cache);
+    
+    g_queue_foreach(&cache->entries, (GFunc)page_surface_free, NULL);
+    g_queue_clear(&cache->entries);
+    gtk_widget_destroy(cache->window);
+    g_ptr_array_unref(cache->app_tiles);
+    g_ptr_array_unref(cache->folder_tiles);
+    g_free(cache);
+    launcher->page_cache = NULL;
+}
@@ -37,6 +37,10 @@
 static void launcher_construct(XfcePanelPlugin *plugin);
 static void launcher_free(XfcePanelPlugin *plugin, LauncherPlugin *launcher);
 static void launcher_configure_plugin(XfcePanelPlugin *plugin, LauncherPlugin *launcher);
+static gboolean on_button_first_draw(GtkWidget *button, cairo_t *cr, LauncherPlugin *launcher);
+static gboolean launcher_start_services(LauncherPlugin *launcher);
+static gboolean launcher_deferred_startup(gpointer data);
+static void launcher_ensure_overlay(LauncherPlugin *launcher);
 
 /* Register the plugin */
 XFCE_PANEL_PLUGIN_REGISTER(launcher_construct);
@@ -44,6 +48,7 @@ XFCE_PANEL_PLUGIN_REGISTER(launcher_construct);
 /* Plugin construction */
 static void launcher_construct(XfcePanelPlugin *plugin) {
     LauncherPlugin *launcher;
+    gint64 start = trace_begin();
     
     /* Allocate memory for the plugin structure */
     launcher = g_slice_new0(LauncherPlugin);
@@ -103,6 +108,9 @@ static void launcher_construct(XfcePanelPlugin *plugin) {
     /* Initialize settings */
     launcher_settings_init(launcher);
     
+    /* Applications, icons and history are shared with the other instances */
+    catalog_attach(launcher);
+    
     /* Connect button click signal */
     g_signal_connect(G_OBJECT(launcher->button), "clicked",
                      G_CALLBACK(launcher_button_clicked), launcher);
@@ -126,20 +134,60 @@ static void launcher_construct(XfcePanelPlugin *plugin) {
     /* Enable context menu for properties */
     xfce_panel_plugin_menu_show_configure(plugin);
     
-    /* Load applications */
-    g_list_free_full(launcher->app_list, (GDestroyNotify)free_app_info);
-    launcher->app_list = load_applications_enhanced();
+    launcher->current_page = 0;
+    
+    /* Time until the button is first drawn */
+    launcher->construct_time = start;
+    g_signal_connect(launcher->button, "draw", G_CALLBACK(on_button_first_draw), launcher);
+    
+    if (launcher_settings_get_lazy_startup(launcher)) {
+        /* Everything else waits until the panel is idle, or until the
+         * user moves towards the button */
+        launcher->startup_idle_id = g_idle_add_full(G_PRIORITY_LOW, launcher_deferred_startup,
+                                                    launcher, NULL);
+        g_signal_connect_swapped(launcher->button, "enter-notify-event",
+                                 G_CALLBACK(launcher_start_services), launcher);
+    } else {
+        launcher_start_services(launcher);
+        launcher_ensure_overlay(launcher);
+    }
+    
+    trace_end(TRACE_CONSTRUCT, start);
+}
 
-    /* Load configuration */
-    load_configuration(launcher);
+static gboolean on_button_first_draw(GtkWidget *button, cairo_t *cr, LauncherPlugin *launcher) {
+    trace_end(TRACE_PANEL_VISIBLE, launcher->construct_time);
+    g_signal_handlers_disconnect_by_func(button, on_button_first_draw, launcher);
+    return FALSE;
+}
 
-    launcher->filtered_list = g_list_copy(launcher->app_list);
-    launcher->current_page = 0;
+/* Start the shared catalog, unless another instance already did.
+ * Safe to call more than once. */
+static gboolean launcher_start_services(LauncherPlugin *launcher) {
+    if (launcher->startup_idle_id) {
+        g_source_remove(launcher->startup_idle_id);
+        launcher->startup_idle_id = 0;
+    }
+    
+    catalog_start_services(launcher->catalog);
+    
+    return FALSE;
+}
+
+static gboolean launcher_deferred_startup(gpointer data) {
+    LauncherPlugin *launcher = data;
     
-    /* Setup application monitoring for automatic refresh */
-    setup_application_monitoring(launcher);
+    launcher->startup_idle_id = 0;
+    launcher_start_services(launcher);
+    return G_SOURCE_REMOVE;
+}
+
+/* Build the overlay window on first use, it is kept (hidden) afterwards */
+static void launcher_ensure_overlay(LauncherPlugin *launcher) {
+    if (launcher->overlay_window)
+        return;
     
-    /* Create overlay window (hidden initially) */
+    launcher->continuous_scroll = launcher_settings_get_continuous_scroll(launcher);
     create_overlay_window(launcher);
     
     /* Store launcher reference in overlay window */
@@ -159,26 +207,32 @@ static void launcher_construct(XfcePanelPlugin *plugin) {
 
 /* Free plugin resources */
 static void launcher_free(XfcePanelPlugin *plugin, LauncherPlugin *launcher) {
-    /* Destroy overlay window */
-    if (launcher->overlay_window)
-        gtk_widget_destroy(launcher->overlay_window);
+    /* Startup may not have run yet */
+    if (launcher->startup_idle_id)
+        g_source_remove(launcher->startup_idle_id);
     
-    /* Free application list */
-    if (launcher->app_list) {
-        g_list_free_full(launcher->app_list, (GDestroyNotify)free_app_info);
-    }
-    if (launcher->filtered_list) {
-        g_list_free(launcher->filtered_list);
+    /* Launches still in flight must not touch the plugin any more */
+    if (launcher->launch_cancellable) {
+        g_cancellable_cancel(launcher->launch_cancellable);
+        g_object_unref(launcher->launch_cancellable);
     }
     
-    /* Free folder list */
-    if (launcher->folder_list) {
-        g_list_free_full(launcher->folder_list, (GDestroyNotify)free_folder_info);
+    /* Destroy overlay window */
+    destroy_overlay_window(launcher);
+    
+    if (launcher->filtered) {
+        g_ptr_array_unref(launcher->filtered);
     }
     
+    /* The last instance takes the applications, icons and history with it */
+    catalog_detach(launcher);
+    
     /* Free settings resources */
     launcher_settings_free(launcher);
     
+    /* Last chance to hand out the timing report */
+    trace_export();
+    
     /* Free the plugin structure */
     g_slice_free(LauncherPlugin, launcher);
 }
@@ -206,11 +260,24 @@ static void launcher_configure_plugin(XfcePanelPlugin *plugin, LauncherPlugin *l
 
 /* Handle button click */
 void launcher_button_clicked(GtkWidget *button, LauncherPlugin *launcher) {
+    launcher_start_services(launcher);
+    
+    /* Pages or continuous scrolling was switched in the settings, or the
+     * button is on a monitor the overlay was not laid out for */
+    if (launcher->overlay_window &&
+        (launcher->continuous_scroll != launcher_settings_get_continuous_scroll(launcher) ||
+         !grid_geometry_equal(&launcher->geometry, grid_geometry_for_view(launcher, NULL))))
+        destroy_overlay_window(launcher);
+    launcher_ensure_overlay(launcher);
+    
     if (launcher->overlay_window) {
         /* Reset to first page when opening */
         launcher->current_page = 0;
+        scroll_view_reset(launcher);
         populate_current_page(launcher);
         update_page_dots(launcher);
+        page_cache_prerender(launcher);
+        prewarm_recent_applications(launcher);
         
         gtk_widget_show_all(launcher->overlay_window);
         gtk_window_present(GTK_WINDOW(launcher->overlay_window));
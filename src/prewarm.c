@@ -0,0 +1,604 @@
+/*
+ * XFCE Launcher Plugin v0.7
+ *
+ * Changelog:
+ * - Hotkey setting to toggle the launcher (integrates with XFCE custom keyboard shortcuts)
+ * - Drag & drop improvements: reorder apps, create folders, add apps to folders
+ * - Search result highlighting (matched text in app names is highlighted)
+ * - Responsive layout: grid size, icon size, and spacing adapt to the current screen resolution
+ * - Settings dialog updated (includes hotkey configuration)
+ * - Configuration saving is more robust (XML attribute escaping)
+ * - Fixed broken drag-and-drop behavior
+ * - Fixed potential memory leak when loading configuration (folder id replacement)
+ * - Fixed callback type mismatches and reduced build warnings
+
+ * Predictive warm-up of likely applications
+ *
+ * Opt-in (see SETTING_PREDICTIVE_WARMUP). When the overlay opens, the
+ * most launched applications are read into the page cache ahead of time;
+ * so is a search result that clearly beats every other match. A single
+ * low-priority thread resolves each program, follows the DT_NEEDED
+ * entries of ELF files to their shared libraries and asks the kernel to
+ * read them with posix_fadvise(WILLNEED), within a per-pass byte budget.
+ * Libraries this process already maps are resident and skipped. The
+ * thread is started by the first warm-up and stopped when the setting
+ * is turned off.
+ *
+ * Every launch is also sampled, warm-up enabled or not: the time spent
+ * spawning and the major page faults of the new process after a few
+ * seconds, split by whether the application had been warmed.
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include "settings.h"
+#include <elf.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+#define PREWARM_RECENT_APPS    3
+#define PREWARM_COOLDOWN       (15 * 60 * G_USEC_PER_SEC)  /* per application */
+#define PREWARM_MAX_FILES      512                         /* per pass */
+#define PREWARM_SAMPLE_DELAY   3                           /* seconds after launch */
+
+/* One warm-up pass, owned by the worker once queued */
+typedef struct {
+    gchar **programs;
+    gint64 budget;              /* bytes */
+} WarmJob;
+
+/* Worker state of a pass */
+typedef struct {
+    GHashTable *seen;           /* canonical paths handled in this pass */
+    GQueue queue;               /* paths still to warm */
+    gint64 budget;
+    gint64 bytes;
+    guint files;
+} WarmPass;
+
+typedef struct {
+    guint launches;
+    gint64 spawn_us;
+    guint samples;
+    guint64 major_faults;
+} LaunchStats;
+
+struct _Prewarm {
+    GThreadPool *pool;
+    gint cancelled;
+    
+    /* Worker only */
+    gchar **library_dirs;
+    GHashTable *resident;       /* libraries mapped by this process */
+    
+    /* Main thread only */
+    GHashTable *warmed;         /* desktop-id -> gint64 monotonic time */
+    GPtrArray *samples;         /* LaunchSample waiting for their timeout */
+    LaunchStats stats[2];       /* indexed by "was warmed" */
+};
+
+typedef struct {
+    Prewarm *prewarm;
+    gboolean warmed;
+    gint64 start;
+    GPid pid;
+    guint source_id;
+} LaunchSample;
+
+/* The worker thread is exclusive to the pool, so this sticks to it */
+static void lower_thread_priority(void) {
+#ifdef __linux__
+    static GPrivate lowered = G_PRIVATE_INIT(NULL);
+    pid_t tid;
+    
+    if (g_private_get(&lowered))
+        return;
+    g_private_set(&lowered, GINT_TO_POINTER(TRUE));
+    
+    tid = syscall(SYS_gettid);
+    setpriority(PRIO_PROCESS, tid, 19);
+#ifdef SYS_ioprio_set
+    /* IOPRIO_WHO_PROCESS, IOPRIO_CLASS_IDLE */
+    syscall(SYS_ioprio_set, 1, tid, 3 << 13);
+#endif
+#endif
+}
+
+/* Library directories used by this process, then the usual fallbacks */
+static void load_library_dirs(Prewarm *prewarm) {
+    static const gchar *fallbacks[] = { "/lib64", "/usr/lib64", "/lib", "/usr/lib", NULL };
+    GPtrArray *dirs = g_ptr_array_new();
+    GHashTable *known = g_hash_table_new(g_str_hash, g_str_equal);
+    gchar *maps = NULL;
+    
+    prewarm->resident = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    
+    if (g_file_get_contents("/proc/self/maps", &maps, NULL, NULL)) {
+        gchar **lines = g_strsplit(maps, "\n", -1);
+        
+        for (gint i = 0; lines[i] != NULL; i++) {
+            gchar *path = strchr(lines[i], '/');
+            gchar *dir;
+            
+            if (!path || !strstr(path, ".so"))
+                continue;
+            
+            g_hash_table_add(prewarm->resident, g_strdup(path));
+            dir = g_path_get_dirname(path);
+            if (!g_hash_table_contains(known, dir)) {
+                g_hash_table_add(known, dir);
+                g_ptr_array_add(dirs, dir);
+            } else {
+                g_free(dir);
+            }
+        }
+        g_strfreev(lines);
+        g_free(maps);
+    }
+    
+    for (gint i = 0; fallbacks[i] != NULL; i++) {
+        if (!g_hash_table_contains(known, fallbacks[i]))
+            g_ptr_array_add(dirs, g_strdup(fallbacks[i]));
+    }
+    
+    g_ptr_array_add(dirs, NULL);
+    prewarm->library_dirs = (gchar **)g_ptr_array_free(dirs, FALSE);
+    g_hash_table_destroy(known);
+}
+
+static void queue_path(WarmPass *pass, Prewarm *prewarm, const gchar *path) {
+    gchar *canonical = realpath(path, NULL);
+    
+    if (!canonical)
+        return;
+    
+    if (g_hash_table_contains(pass->seen, canonical) ||
+        g_hash_table_contains(prewarm->resident, canonical) ||
+        g_hash_table_size(pass->seen) >= PREWARM_MAX_FILES) {
+        free(canonical);
+        return;
+    }
+    
+    g_hash_table_add(pass->seen, g_strdup(canonical));
+    g_queue_push_tail(&pass->queue, g_strdup(canonical));
+    free(canonical);
+}
+
+/* Queue the shared library name, looked up like the dynamic linker would */
+static void queue_library(WarmPass *pass, Prewarm *prewarm, const gchar *name,
+                          const gchar *runpath, const gchar *origin) {
+    if (strchr(name, '/')) {
+        queue_path(pass, prewarm, name);
+        return;
+    }
+    
+    if (runpath) {
+        gchar **dirs = g_strsplit(runpath, ":", -1);
+        
+        for (gint i = 0; dirs[i] != NULL; i++) {
+            gchar *dir = g_str_has_prefix(dirs[i], "$ORIGIN") ?
+                         g_strconcat(origin, dirs[i] + strlen("$ORIGIN"), NULL) :
+                         g_strdup(dirs[i]);
+            gchar *path = g_build_filename(dir, name, NULL);
+            gboolean found = g_file_test(path, G_FILE_TEST_IS_REGULAR);
+            
+            if (found)
+                queue_path(pass, prewarm, path);
+            g_free(path);
+            g_free(dir);
+            if (found) {
+                g_strfreev(dirs);
+                return;
+            }
+        }
+        g_strfreev(dirs);
+    }
+    
+    for (gint i = 0; prewarm->library_dirs[i] != NULL; i++) {
+        gchar *path = g_build_filename(prewarm->library_dirs[i], name, NULL);
+        gboolean found = g_file_test(path, G_FILE_TEST_IS_REGULAR);
+        
+        if (found)
+            queue_path(pass, prewarm, path);
+        g_free(path);
+        if (found)
+            return;
+    }
+}
+
+static gboolean vaddr_to_offset(const Elf64_Phdr *phdr, guint n_phdr, guint64 vaddr, guint64 *offset) {
+    for (guint i = 0; i < n_phdr; i++) {
+        if (phdr[i].p_type == PT_LOAD &&
+            vaddr >= phdr[i].p_vaddr && vaddr < phdr[i].p_vaddr + phdr[i].p_filesz) {
+            *offset = vaddr - phdr[i].p_vaddr + phdr[i].p_offset;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/* Queue the DT_NEEDED libraries of a 64-bit ELF file */
+static void queue_dependencies(WarmPass *pass, Prewarm *prewarm, const gchar *path,
+                               const guint8 *data, gsize size) {
+    const Elf64_Ehdr *ehdr = (const Elf64_Ehdr *)data;
+    const Elf64_Phdr *phdr;
+    const Elf64_Dyn *dyn = NULL;
+    gsize n_dyn = 0;
+    guint64 strtab = 0, strtab_offset;
+    guint64 runpath = G_MAXUINT64;
+    const gchar *strings;
+    gsize strings_size;
+    gchar *origin;
+    
+    if (size < sizeof(Elf64_Ehdr) || memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0 ||
+        ehdr->e_ident[EI_CLASS] != ELFCLASS64 ||
+        ehdr->e_phoff + (guint64)ehdr->e_phnum * sizeof(Elf64_Phdr) > size)
+        return;
+    
+    phdr = (const Elf64_Phdr *)(data + ehdr->e_phoff);
+    for (guint i = 0; i < ehdr->e_phnum; i++) {
+        if (phdr[i].p_type == PT_DYNAMIC && phdr[i].p_offset + phdr[i].p_filesz <= size) {
+            dyn = (const Elf64_Dyn *)(data + phdr[i].p_offset);
+            n_dyn = phdr[i].p_filesz / sizeof(Elf64_Dyn);
+        }
+    }
+    
+    for (gsize i = 0; i < n_dyn && dyn[i].d_tag != DT_NULL; i++) {
+        if (dyn[i].d_tag == DT_STRTAB)
+            strtab = dyn[i].d_un.d_ptr;
+        else if (dyn[i].d_tag == DT_RUNPATH || (dyn[i].d_tag == DT_RPATH && runpath == G_MAXUINT64))
+            runpath = dyn[i].d_un.d_val;
+    }
+    
+    if (!dyn || !vaddr_to_offset(phdr, ehdr->e_phnum, strtab, &strtab_offset) || strtab_offset >= size)
+        return;
+    
+    strings = (const gchar *)data + strtab_offset;
+    strings_size = size - strtab_offset;
+    origin = g_path_get_dirname(path);
+    
+#define DYN_STRING(value) ((value) < strings_size && memchr(strings + (value), '\0', strings_size - (value)) ? \
+                           strings + (value) : NULL)
+    
+    for (gsize i = 0; i < n_dyn && dyn[i].d_tag != DT_NULL; i++) {
+        const gchar *name;
+        
+        if (dyn[i].d_tag != DT_NEEDED || !(name = DYN_STRING(dyn[i].d_un.d_val)))
+            continue;
+        queue_library(pass, prewarm, name, runpath != G_MAXUINT64 ? DYN_STRING(runpath) : NULL, origin);
+    }
+    
+#undef DYN_STRING
+    g_free(origin);
+}
+
+/* Ask for path to be read ahead and queue what it needs to run */
+static void warm_file(WarmPass *pass, Prewarm *prewarm, const gchar *path) {
+    struct stat st;
+    guint8 *data;
+    gint fd = open(path, O_RDONLY | O_CLOEXEC);
+    
+    if (fd < 0)
+        return;
+    
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0 ||
+        pass->bytes + st.st_size > pass->budget) {
+        close(fd);
+        return;
+    }
+    
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    pass->bytes += st.st_size;
+    pass->files++;
+    
+    data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+        if (st.st_size > 2 && data[0] == '#' && data[1] == '!') {
+            /* Script: warm the interpreter too */
+            gsize length = MIN((gsize)st.st_size, 256) - 2;
+            const guint8 *newline = memchr(data + 2, '\n', length);
+            gchar *line = g_strndup((const gchar *)data + 2, newline ? (gsize)(newline - data - 2) : length);
+            gchar **argv = g_strsplit_set(g_strstrip(line), " \t", 2);
+            
+            if (argv[0] && g_path_is_absolute(argv[0]))
+                queue_path(pass, prewarm, argv[0]);
+            g_strfreev(argv);
+            g_free(line);
+        } else {
+            queue_dependencies(pass, prewarm, path, data, st.st_size);
+        }
+        munmap(data, st.st_size);
+    }
+    close(fd);
+}
+
+static void warm_job_free(WarmJob *job) {
+    g_strfreev(job->programs);
+    g_free(job);
+}
+
+static void run_warm_job(WarmJob *job, Prewarm *prewarm) {
+    WarmPass pass = { 0 };
+    gint64 start = g_get_monotonic_time();
+    gchar *path;
+    
+    if (g_atomic_int_get(&prewarm->cancelled)) {
+        warm_job_free(job);
+        return;
+    }
+    
+    lower_thread_priority();
+    if (!prewarm->library_dirs)
+        load_library_dirs(prewarm);
+    
+    pass.seen = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    g_queue_init(&pass.queue);
+    pass.budget = job->budget;
+    
+    for (gint i = 0; job->programs[i] != NULL; i++) {
+        gchar *program = g_find_program_in_path(job->programs[i]);
+        
+        if (!program)
+            continue;
+        
+        /* Each application starts from its own program, libraries seen
+         * for an earlier one are not read again */
+        queue_path(&pass, prewarm, program);
+        while ((path = g_queue_pop_head(&pass.queue)) != NULL) {
+            if (!g_atomic_int_get(&prewarm->cancelled) && pass.bytes < pass.budget)
+                warm_file(&pass, prewarm, path);
+            g_free(path);
+        }
+        g_free(program);
+    }
+    
+    g_debug("Warm-up: %u files, %" G_GINT64_FORMAT " KiB advised in %.1f ms%s",
+            pass.files, pass.bytes / 1024, (g_get_monotonic_time() - start) / 1000.0,
+            pass.bytes >= pass.budget ? " (budget exhausted)" : "");
+    
+    g_hash_table_destroy(pass.seen);
+    warm_job_free(job);
+}
+
+void prewarm_new(Catalog *catalog) {
+    Prewarm *prewarm = g_new0(Prewarm, 1);
+    
+    prewarm->warmed = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    prewarm->samples = g_ptr_array_new();
+    
+    /* The thread is only started once warm-up is enabled and needed */
+    catalog->prewarm = prewarm;
+}
+
+/* Start the worker thread on first use */
+static gboolean start_pool(Prewarm *prewarm) {
+    GError *error = NULL;
+    
+    if (prewarm->pool)
+        return TRUE;
+    
+    /* One exclusive thread, so lowering its priority affects nothing else */
+    g_atomic_int_set(&prewarm->cancelled, FALSE);
+    prewarm->pool = g_thread_pool_new((GFunc)run_warm_job, prewarm, 1, TRUE, &error);
+    if (!prewarm->pool) {
+        g_warning("Failed to start the warm-up thread: %s", error->message);
+        g_error_free(error);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* Stop the worker thread and drop what it learnt about this process */
+static void stop_pool(Prewarm *prewarm) {
+    if (!prewarm->pool)
+        return;
+    
+    /* Queued jobs still run, but only to free themselves */
+    g_atomic_int_set(&prewarm->cancelled, TRUE);
+    g_thread_pool_free(prewarm->pool, FALSE, TRUE);
+    prewarm->pool = NULL;
+    
+    g_clear_pointer(&prewarm->resident, g_hash_table_destroy);
+    g_clear_pointer(&prewarm->library_dirs, g_strfreev);
+}
+
+/* Warm-up was turned off, the thread goes away until it is turned on again */
+void prewarm_disable(Catalog *catalog) {
+    if (catalog->prewarm)
+        stop_pool(catalog->prewarm);
+}
+
+static void log_launch_stats(Prewarm *prewarm) {
+    for (gint warmed = 0; warmed < 2; warmed++) {
+        LaunchStats *stats = &prewarm->stats[warmed];
+        
+        if (stats->launches == 0)
+            continue;
+        g_debug("Launches %s warm-up: %u, spawn %.1f ms avg, %.0f major faults avg over %u samples",
+                warmed ? "with" : "without", stats->launches,
+                stats->spawn_us / 1000.0 / stats->launches,
+                stats->samples ? (gdouble)stats->major_faults / stats->samples : 0.0,
+                stats->samples);
+    }
+}
+
+void prewarm_free(Catalog *catalog) {
+    Prewarm *prewarm = catalog->prewarm;
+    
+    if (!prewarm)
+        return;
+    
+    stop_pool(prewarm);
+    
+    for (guint i = 0; i < prewarm->samples->len; i++) {
+        LaunchSample *sample = g_ptr_array_index(prewarm->samples, i);
+        
+        g_source_remove(sample->source_id);
+        g_free(sample);
+    }
+    g_ptr_array_unref(prewarm->samples);
+    
+    log_launch_stats(prewarm);
+    
+    g_hash_table_destroy(prewarm->warmed);
+    g_free(prewarm);
+    catalog->prewarm = NULL;
+}
+
+static gboolean recently_warmed(Prewarm *prewarm, const gchar *desktop_id, gint64 now) {
+    gint64 *last = desktop_id ? g_hash_table_lookup(prewarm->warmed, desktop_id) : NULL;
+    
+    return last && now - *last < PREWARM_COOLDOWN;
+}
+
+static void queue_warmup(LauncherPlugin *launcher, GList *apps) {
+    Prewarm *prewarm = launcher->catalog->prewarm;
+    GPtrArray *programs;
+    gint64 now = g_get_monotonic_time();
+    WarmJob *job;
+    
+    if (!prewarm)
+        return;
+    
+    /* The setting may also have been changed outside the dialog */
+    if (!launcher_settings_get_predictive_warmup(launcher)) {
+        stop_pool(prewarm);
+        return;
+    }
+    
+    programs = g_ptr_array_new_with_free_func(g_free);
+    for (GList *iter = apps; iter != NULL; iter = g_list_next(iter)) {
+        AppInfo *app = (AppInfo *)iter->data;
+        gchar *program;
+        gint64 *last;
+        
+        if (!app->desktop_id || recently_warmed(prewarm, app->desktop_id, now))
+            continue;
+        
+        program = app_info_get_program(app);
+        if (!program)
+            continue;
+        
+        g_ptr_array_add(programs, program);
+        last = g_new(gint64, 1);
+        *last = now;
+        g_hash_table_insert(prewarm->warmed, g_strdup(app->desktop_id), last);
+    }
+    
+    if (programs->len == 0 || !start_pool(prewarm)) {
+        g_ptr_array_free(programs, TRUE);
+        return;
+    }
+    
+    g_ptr_array_add(programs, NULL);
+    job = g_new0(WarmJob, 1);
+    job->programs = (gchar **)g_ptr_array_free(programs, FALSE);
+    job->budget = (gint64)launcher_settings_get_warmup_budget_mb(launcher) * 1024 * 1024;
+    g_thread_pool_push(prewarm->pool, job, NULL);
+}
+
+/* Warm the most launched applications, called when the overlay opens */
+void prewarm_recent_applications(LauncherPlugin *launcher) {
+    GList *recent;
+    
+    if (!launcher->catalog->prewarm)
+        return;
+    if (!launcher_settings_get_predictive_warmup(launcher)) {
+        stop_pool(launcher->catalog->prewarm);
+        return;
+    }
+    
+    recent = launch_history_top(launcher, PREWARM_RECENT_APPS);
+    queue_warmup(launcher, recent);
+    g_list_free(recent);
+}
+
+/* Warm a single likely application, e.g. the only match of a search */
+void prewarm_application(LauncherPlugin *launcher, AppInfo *app_info) {
+    GList single = { app_info, NULL, NULL };
+    
+    queue_warmup(launcher, &single);
+}
+
+static gboolean sample_major_faults(LaunchSample *sample) {
+    Prewarm *prewarm = sample->prewarm;
+    gchar *path = g_strdup_printf("/proc/%d/stat", (gint)sample->pid);
+    gchar *contents = NULL;
+    
+    if (g_file_get_contents(path, &contents, NULL, NULL)) {
+        /* Fields after the command name, which may contain spaces */
+        gchar *fields = strrchr(contents, ')');
+        gchar **values = fields ? g_strsplit(fields + 2, " ", 12) : NULL;
+        
+        /* state ppid pgrp session tty_nr tpgid flags minflt cminflt majflt cmajflt */
+        if (values && g_strv_length(values) >= 11) {
+            LaunchStats *stats = &prewarm->stats[sample->warmed];
+            guint64 faults = g_ascii_strtoull(values[9], NULL, 10) +
+                             g_ascii_strtoull(values[10], NULL, 10);
+            
+            stats->samples++;
+            stats->major_faults += faults;
+            g_debug("Launched pid %d (%s): %" G_GUINT64_FORMAT " major faults after %d s",
+                    (gint)sample->pid, sample->warmed ? "warmed" : "cold",
+                    faults, PREWARM_SAMPLE_DELAY);
+            log_launch_stats(prewarm);
+        }
+        g_strfreev(values);
+        g_free(contents);
+    }
+    g_free(path);
+    
+    g_ptr_array_remove_fast(prewarm->samples, sample);
+    g_free(sample);
+    return G_SOURCE_REMOVE;
+}
+
+static void on_app_launched(GAppLaunchContext *context, GAppInfo *info,
+                            GVariant *platform_data, LaunchSample *pending) {
+    Prewarm *prewarm = pending->prewarm;
+    LaunchStats *stats = &prewarm->stats[pending->warmed];
+    LaunchSample *sample;
+    gint32 pid;
+    
+    stats->launches++;
+    stats->spawn_us += g_get_monotonic_time() - pending->start;
+    trace_end(TRACE_LAUNCH_SPAWN, pending->start);
+    
+    if (!g_variant_lookup(platform_data, "pid", "i", &pid))
+        return;
+    
+    sample = g_new(LaunchSample, 1);
+    *sample = *pending;
+    sample->pid = pid;
+    sample->source_id = g_timeout_add_seconds(PREWARM_SAMPLE_DELAY,
+                                              (GSourceFunc)sample_major_faults, sample);
+    g_ptr_array_add(prewarm->samples, sample);
+}
+
+/* Record the launch of app_info through context in the launch statistics */
+void prewarm_watch_launch(LauncherPlugin *launcher, AppInfo *app_info, GAppLaunchContext *context) {
+    Prewarm *prewarm = launcher->catalog->prewarm;
+    LaunchSample *pending;
+    
+    if (!prewarm)
+        return;
+    
+    pending = g_new0(LaunchSample, 1);
+    pending->prewarm = prewarm;
+    pending->start = g_get_monotonic_time();
+    pending->warmed = recently_warmed(prewarm, app_info->desktop_id, pending->start);
+    
+    g_signal_connect_data(context, "launched", G_CALLBACK(on_app_launched),
+                          pending, (GClosureNotify)g_free, 0);
+}
@@ -0,0 +1,170 @@
+/*
+ * XFCE Launcher Plugin v0.7
+ *
+ * Changelog:
+ * - Hotkey setting to toggle the launcher (integrates with XFCE custom keyboard shortcuts)
+ * - Drag & drop improvements: reorder apps, create folders, add apps to folders
+ * - Search result highlighting (matched text in app names is highlighted)
+ * - Responsive layout: grid size, icon size, and spacing adapt to the current screen resolution
+ * - Settings dialog updated (includes hotkey configuration)
+ * - Configuration saving is more robust (XML attribute escaping)
+ * - Fixed broken drag-and-drop behavior
+ * - Fixed potential memory leak when loading configuration (folder id replacement)
+ * - Fixed callback type mismatches and reduced build warnings
+
+ * Continuous scroll view
+ *
+ * Instead of pages the whole list scrolls vertically. The scrolled area
+ * is a GtkLayout as tall as every row of entries, but only the rows in
+ * view plus SCROLL_OVERSCAN_ROWS above and below are bound to tiles: the
+ * grid of tiles is moved along inside the layout and rebound whenever
+ * the first row in view changes, so the number of widgets depends on the
+ * height of the screen, not on the number of applications.
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <math.h>
+
+#define SCROLL_OVERSCAN_ROWS 1
+
+struct _ScrollView {
+    LauncherPlugin *launcher;
+    GtkWidget *layout;
+    GtkAdjustment *vadjustment;
+    guint first_row;            /* bound to the first row of the grid */
+    guint n_rows;               /* bound rows, 0 before the first update */
+    guint update_id;
+};
+
+static guint count_entries(LauncherPlugin *launcher) {
+    GPtrArray *apps = launcher->open_folder ? launcher->open_folder->apps : launcher->filtered;
+    
+    return g_list_length(launcher->catalog->folder_list) + apps->len;
+}
+
+/* Size the layout for every row of entries */
+static void update_extent(ScrollView *view) {
+    const GridGeometry *geometry = &view->launcher->geometry;
+    guint total_rows = (count_entries(view->launcher) + geometry->columns - 1) / geometry->columns;
+    gint pitch = grid_geometry_get_pitch(geometry);
+    gint width = geometry->columns * pitch - geometry->spacing;
+    gint height = MAX((gint)total_rows * pitch - geometry->spacing, 0);
+    
+    gtk_widget_set_size_request(view->layout, width, -1);
+    gtk_layout_set_size(GTK_LAYOUT(view->layout), width, height);
+}
+
+/* Rebind the grid to the rows in view, unless it already shows them */
+static void update_rows(ScrollView *view, gboolean force) {
+    LauncherPlugin *launcher = view->launcher;
+    const GridGeometry *geometry = &launcher->geometry;
+    gdouble page_size = gtk_adjustment_get_page_size(view->vadjustment);
+    gdouble value = gtk_adjustment_get_value(view->vadjustment);
+    gint row_pitch = grid_geometry_get_pitch(geometry);
+    guint first_row, n_rows;
+    
+    /* Before the first allocation there is no page size yet */
+    n_rows = page_size > 0 ? (guint)ceil(page_size / row_pitch) + 1 : (guint)geometry->rows;
+    n_rows += 2 * SCROLL_OVERSCAN_ROWS;
+    first_row = (guint)MAX(floor(value / row_pitch) - SCROLL_OVERSCAN_ROWS, 0);
+    
+    if (!force && first_row == view->first_row && n_rows == view->n_rows)
+        return;
+    
+    view->first_row = first_row;
+    view->n_rows = n_rows;
+    populate_grid_range(launcher, launcher->app_grid, launcher->app_tiles, launcher->folder_tiles,
+                        first_row * geometry->columns, n_rows * geometry->columns);
+    gtk_layout_move(GTK_LAYOUT(view->layout), launcher->app_grid, 0, (gint)first_row * row_pitch);
+}
+
+static void on_value_changed(GtkAdjustment *adjustment, ScrollView *view) {
+    update_rows(view, FALSE);
+}
+
+static gboolean on_update_idle(gpointer data) {
+    ScrollView *view = data;
+    
+    view->update_id = 0;
+    update_rows(view, FALSE);
+    return G_SOURCE_REMOVE;
+}
+
+/* The page size changes while the layout is being allocated, where the
+ * tiles cannot be rebound */
+static void on_adjustment_changed(GtkAdjustment *adjustment, ScrollView *view) {
+    if (!view->update_id)
+        view->update_id = g_idle_add(on_update_idle, view);
+}
+
+/* Wrap launcher->app_grid in a scrolled window, which becomes
+ * launcher->scrolled_window */
+void scroll_view_new(LauncherPlugin *launcher) {
+    ScrollView *view = g_new0(ScrollView, 1);
+    
+    view->launcher = launcher;
+    launcher->scroll_view = view;
+    
+    launcher->scrolled_window = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(launcher->scrolled_window),
+                                   GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+    gtk_scrolled_window_set_propagate_natural_width(GTK_SCROLLED_WINDOW(launcher->scrolled_window), TRUE);
+    gtk_widget_set_halign(launcher->scrolled_window, GTK_ALIGN_CENTER);
+    
+    view->layout = gtk_layout_new(NULL, NULL);
+    gtk_container_add(GTK_CONTAINER(launcher->scrolled_window), view->layout);
+    gtk_layout_put(GTK_LAYOUT(view->layout), launcher->app_grid, 0, 0);
+    
+    view->vadjustment = gtk_scrollable_get_vadjustment(GTK_SCROLLABLE(view->layout));
+    g_signal_connect(view->vadjustment, "value-changed", G_CALLBACK(on_value_changed), view);
+    g_signal_connect(view->vadjustment, "changed", G_CALLBACK(on_adjustment_changed), view);
+}
+
+void scroll_view_free(LauncherPlugin *launcher) {
+    ScrollView *view = launcher->scroll_view;
+    
+    if (!view)
+        return;
+    
+    if (view->update_id)
+        g_source_remove(view->update_id);
+    g_signal_handlers_disconnect_by_data(view->vadjustment, view);
+    g_free(view);
+    launcher->scroll_view = NULL;
+}
+
+/* The entries changed, rebind the rows in view */
+void scroll_view_populate(LauncherPlugin *launcher) {
+    ScrollView *view = launcher->scroll_view;
+    
+    update_extent(view);
+    update_rows(view, TRUE);
+}
+
+/* The number of entries changed, the ones in view did not */
+void scroll_view_update_extent(LauncherPlugin *launcher) {
+    update_extent(launcher->scroll_view);
+}
+
+/* Back to the first row, for a new search or folder */
+void scroll_view_reset(LauncherPlugin *launcher) {
+    if (launcher->scroll_view)
+        gtk_adjustment_set_value(launcher->scroll_view->vadjustment, 0);
+}
+
+/* Index of the entry in the first cell of the grid */
+guint scroll_view_get_first_index(LauncherPlugin *launcher) {
+    return launcher->scroll_view->first_row * launcher->geometry.columns;
+}
+
+/* Index one past the last entry bound to the grid */
+guint scroll_view_get_end_index(LauncherPlugin *launcher) {
+    ScrollView *view = launcher->scroll_view;
+    
+    return (view->first_row + MAX(view->n_rows, (guint)launcher->geometry.rows)) *
+           launcher->geometry.columns;
+}
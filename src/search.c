@@ -0,0 +1,371 @@
+/*
+ * XFCE Launcher Plugin v0.7
+ *
+ * Changelog:
+ * - Hotkey setting to toggle the launcher (integrates with XFCE custom keyboard shortcuts)
+ * - Drag & drop improvements: reorder apps, create folders, add apps to folders
+ * - Search result highlighting (matched text in app names is highlighted)
+ * - Responsive layout: grid size, icon size, and spacing adapt to the current screen resolution
+ * - Settings dialog updated (includes hotkey configuration)
+ * - Configuration saving is more robust (XML attribute escaping)
+ * - Fixed broken drag-and-drop behavior
+ * - Fixed potential memory leak when loading configuration (folder id replacement)
+ * - Fixed callback type mismatches and reduced build warnings
+
+ * Search index
+ *
+ * Each application gets a compact search record, built once per catalog
+ * change: the case folded name, generic name, keywords, exec basename and
+ * categories in one shared buffer, plus a 64-bit mask of the bytes they
+ * contain. A query is split into terms; every term has to match one of the
+ * fields as a subsequence, scored with bonuses for prefixes, word
+ * boundaries and consecutive characters, weighted by field. Results come
+ * back best score first, frequently and recently launched applications
+ * ahead of equally good matches. When the query only grew, only the
+ * previous matches are scored again.
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <math.h>
+#include <string.h>
+
+#define SEARCH_NO_FIELD G_MAXUINT32
+#define SEARCH_MAX_TERMS 8
+#define SEARCH_HISTORY_WEIGHT 40    /* per doubling of launch frecency */
+#define SEARCH_HISTORY_MAX 160
+#define SEARCH_DOMINANT_RATIO 2     /* best score over the runner-up */
+
+/* Fields in match priority order and their score weights */
+enum {
+    FIELD_NAME,
+    FIELD_GENERIC_NAME,
+    FIELD_KEYWORDS,
+    FIELD_EXEC,
+    FIELD_CATEGORIES,
+    N_FIELDS
+};
+
+static const gint field_weights[N_FIELDS] = { 4, 3, 3, 2, 1 };
+
+typedef struct {
+    AppInfo *app;
+    guint32 fields[N_FIELDS];   /* offsets of the folded fields in text */
+    guint64 mask;               /* bytes present in any field */
+} SearchRecord;
+
+typedef struct {
+    guint32 record;
+    gint score;
+} SearchMatch;
+
+struct _SearchIndex {
+    gboolean valid;
+    GArray *records;            /* SearchRecord, in catalog order */
+    GString *text;              /* folded fields, NUL separated */
+    
+    /* Last query, for incremental refinement */
+    gchar *last_query;
+    GArray *last_results;       /* matching record indices, ascending */
+    AppInfo *dominant;          /* clear winner of the last query, if any */
+};
+
+/* Case and compatibility folded form used on both sides of a match */
+static gchar* fold_string(const gchar *str) {
+    gchar *casefolded = g_utf8_casefold(str, -1);
+    gchar *normalized = g_utf8_normalize(casefolded, -1, G_NORMALIZE_ALL);
+    
+    g_free(casefolded);
+    return normalized ? normalized : g_strdup("");
+}
+
+static inline guint64 byte_bit(guchar c) {
+    return G_GUINT64_CONSTANT(1) << (c < 0x80 ? (c & 63) : 63);
+}
+
+static guint64 string_mask(const gchar *str) {
+    guint64 mask = 0;
+    
+    for (; *str; str++)
+        mask |= byte_bit(*str);
+    return mask;
+}
+
+static inline gboolean is_boundary(gchar c) {
+    return c == ' ' || c == '-' || c == '_' || c == '.' || c == ';' || c == '/';
+}
+
+SearchIndex* search_index_new(void) {
+    SearchIndex *index = g_new0(SearchIndex, 1);
+    
+    index->records = g_array_new(FALSE, FALSE, sizeof(SearchRecord));
+    index->text = g_string_new(NULL);
+    index->last_results = g_array_new(FALSE, FALSE, sizeof(guint32));
+    
+    return index;
+}
+
+void search_index_free(SearchIndex *index) {
+    if (!index)
+        return;
+    
+    g_array_unref(index->records);
+    g_string_free(index->text, TRUE);
+    g_array_unref(index->last_results);
+    g_free(index->last_query);
+    g_free(index);
+}
+
+/* Mark the index out of date; it is rebuilt by the next query */
+void search_index_invalidate(Catalog *catalog) {
+    SearchIndex *index = catalog->search_index;
+    
+    if (!index)
+        return;
+    
+    index->valid = FALSE;
+    index->dominant = NULL;
+    g_clear_pointer(&index->last_query, g_free);
+}
+
+static guint32 add_field(SearchIndex *index, SearchRecord *record, const gchar *value) {
+    guint32 offset;
+    gchar *folded;
+    
+    if (!value || !*value)
+        return SEARCH_NO_FIELD;
+    
+    folded = fold_string(value);
+    offset = index->text->len;
+    g_string_append_len(index->text, folded, strlen(folded) + 1);
+    record->mask |= string_mask(folded);
+    g_free(folded);
+    
+    return offset;
+}
+
+static void search_index_build(SearchIndex *index, GPtrArray *apps) {
+    g_array_set_size(index->records, 0);
+    g_string_truncate(index->text, 0);
+    
+    for (guint i = 0; i < apps->len; i++) {
+        AppInfo *app = g_ptr_array_index(apps, i);
+        SearchRecord record = { 0 };
+        gchar *exec;
+        
+        if (!app->name)
+            continue;
+        
+        exec = app_info_get_program(app);
+        if (exec) {
+            gchar *basename = g_path_get_basename(exec);
+            
+            g_free(exec);
+            exec = basename;
+        }
+        record.app = app;
+        record.fields[FIELD_NAME] = add_field(index, &record, app->name);
+        record.fields[FIELD_GENERIC_NAME] = add_field(index, &record, app->generic_name);
+        record.fields[FIELD_KEYWORDS] = add_field(index, &record, app->keywords);
+        record.fields[FIELD_EXEC] = add_field(index, &record, exec);
+        record.fields[FIELD_CATEGORIES] = add_field(index, &record, app->categories);
+        g_array_append_val(index->records, record);
+        g_free(exec);
+    }
+    
+    index->valid = TRUE;
+    g_clear_pointer(&index->last_query, g_free);
+}
+
+/* Score term as a subsequence of text, -1 if it does not match. A
+ * contiguous occurrence is preferred over the leftmost scattered one. */
+static gint score_term(const gchar *text, const gchar *term, gsize term_length) {
+    const gchar *found;
+    gint score = 0;
+    gint last = -2;
+    gsize matched = 0;
+    
+    found = strstr(text, term);
+    if (found) {
+        gint pos = found - text;
+        
+        score = term_length * 18;
+        if (pos == 0)
+            score += 25;
+        else if (is_boundary(text[pos - 1]))
+            score += 15;
+        /* Whole field matched */
+        if (found[term_length] == '\0' && pos == 0)
+            score += 10;
+        return score;
+    }
+    
+    for (gint i = 0; text[i] && matched < term_length; i++) {
+        gint bonus;
+        
+        if (text[i] != term[matched])
+            continue;
+        
+        bonus = 10;
+        if (i == 0)
+            bonus += 15;
+        else if (is_boundary(text[i - 1]))
+            bonus += 10;
+        
+        if (last == i - 1)
+            bonus += 8;
+        else if (last >= 0)
+            bonus -= MIN(i - last - 1, 5);
+        
+        score += bonus;
+        last = i;
+        matched++;
+    }
+    
+    return matched == term_length ? score : -1;
+}
+
+/* Best weighted score of term over the fields of record */
+static gint score_record(SearchIndex *index, const SearchRecord *record,
+                         const gchar *term, gsize term_length) {
+    gint best = -1;
+    
+    for (gint f = 0; f < N_FIELDS; f++) {
+        gint score;
+        
+        if (record->fields[f] == SEARCH_NO_FIELD)
+            continue;
+        
+        score = score_term(index->text->str + record->fields[f], term, term_length);
+        if (score >= 0)
+            best = MAX(best, score * field_weights[f]);
+    }
+    
+    return best;
+}
+
+static gint compare_matches(gconstpointer a, gconstpointer b) {
+    const SearchMatch *match_a = a, *match_b = b;
+    
+    if (match_a->score != match_b->score)
+        return match_b->score - match_a->score;
+    /* Equal scores keep catalog order */
+    return (match_a->record > match_b->record) - (match_a->record < match_b->record);
+}
+
+/* Listed entries of the catalog matching text, best match first */
+GPtrArray* search_index_query(LauncherPlugin *launcher, const gchar *text) {
+    SearchIndex *index;
+    GArray *candidates = NULL;
+    GArray *results;
+    GArray *matches;
+    GPtrArray *list;
+    gchar *query;
+    gchar *terms[SEARCH_MAX_TERMS];
+    gsize term_lengths[SEARCH_MAX_TERMS];
+    gint n_terms = 0;
+    guint64 mask;
+    guint n_candidates;
+    
+    if (!launcher->catalog->search_index)
+        launcher->catalog->search_index = search_index_new();
+    index = launcher->catalog->search_index;
+    if (!index->valid)
+        search_index_build(index, launcher->catalog->apps);
+    
+    query = fold_string(text);
+    mask = string_mask(query) & ~byte_bit(' ');
+    
+    /* Split in place on spaces */
+    for (gchar *p = query; *p && n_terms < SEARCH_MAX_TERMS; ) {
+        gchar *end;
+        
+        while (*p == ' ' || *p == '\t')
+            p++;
+        if (!*p)
+            break;
+        end = p;
+        while (*end && *end != ' ' && *end != '\t')
+            end++;
+        terms[n_terms] = p;
+        term_lengths[n_terms] = end - p;
+        n_terms++;
+        p = end;
+    }
+    
+    /* Matches of a longer query are a subset of the previous matches */
+    if (index->last_query && g_str_has_prefix(query, index->last_query))
+        candidates = index->last_results;
+    n_candidates = candidates ? candidates->len : index->records->len;
+    
+    results = g_array_new(FALSE, FALSE, sizeof(guint32));
+    matches = g_array_new(FALSE, FALSE, sizeof(SearchMatch));
+    
+    for (guint i = 0; i < n_candidates; i++) {
+        guint32 record_index = candidates ? g_array_index(candidates, guint32, i) : i;
+        SearchRecord *record = &g_array_index(index->records, SearchRecord, record_index);
+        SearchMatch match = { record_index, 0 };
+        gdouble frecency;
+        gint t;
+        
+        if ((record->mask & mask) != mask)
+            continue;
+        
+        for (t = 0; t < n_terms; t++) {
+            gchar saved = terms[t][term_lengths[t]];
+            gint score;
+            
+            terms[t][term_lengths[t]] = '\0';
+            score = score_record(index, record, terms[t], term_lengths[t]);
+            terms[t][term_lengths[t]] = saved;
+            
+            if (score < 0)
+                break;
+            match.score += score;
+        }
+        if (t < n_terms)
+            continue;
+        
+        g_array_append_val(results, record_index);
+        /* Hidden and filed entries stay in the results for refinement, but are not shown */
+        if (record->app->is_hidden || record->app->folder_id)
+            continue;
+        
+        frecency = launch_history_score(launcher, record->app->desktop_id);
+        if (frecency > 0)
+            match.score += MIN((gint)(SEARCH_HISTORY_WEIGHT * log2(1.0 + frecency)),
+                               SEARCH_HISTORY_MAX);
+        g_array_append_val(matches, match);
+    }
+    
+    g_array_sort(matches, compare_matches);
+    index->dominant = NULL;
+    if (matches->len == 1 ||
+        (matches->len > 1 &&
+         g_array_index(matches, SearchMatch, 0).score >=
+         SEARCH_DOMINANT_RATIO * g_array_index(matches, SearchMatch, 1).score)) {
+        index->dominant = g_array_index(index->records, SearchRecord,
+                                        g_array_index(matches, SearchMatch, 0).record).app;
+    }
+    list = g_ptr_array_sized_new(matches->len);
+    for (guint i = 0; i < matches->len; i++) {
+        SearchMatch *match = &g_array_index(matches, SearchMatch, i);
+        g_ptr_array_add(list, g_array_index(index->records, SearchRecord, match->record).app);
+    }
+    g_array_unref(matches);
+    
+    g_array_unref(index->last_results);
+    index->last_results = results;
+    g_free(index->last_query);
+    index->last_query = query;
+    
+    return list;
+}
+
+/* The match of the last query that clearly beats all others, or NULL */
+AppInfo* search_index_dominant_match(LauncherPlugin *launcher) {
+    return launcher->catalog->search_index ? launcher->catalog->search_index->dominant : NULL;
+}
@@ -102,6 +102,62 @@ void launcher_settings_set_icon_name(LauncherPlugin *launcher, const gchar *icon
     gtk_image_set_pixel_size(GTK_IMAGE(launcher->icon), size - 4);
 }
 
+/* Quiet window for coalescing application directory changes */
+guint launcher_settings_get_monitor_quiet_ms(LauncherPlugin *launcher) {
+    if (!launcher->channel)
+        return DEFAULT_MONITOR_QUIET_MS;
+    
+    return MAX(xfconf_channel_get_uint(launcher->channel, SETTING_MONITOR_QUIET_MS,
+                                       DEFAULT_MONITOR_QUIET_MS), 1);
+}
+
+/* Whether likely applications are read into the page cache ahead of launch */
+gboolean launcher_settings_get_predictive_warmup(LauncherPlugin *launcher) {
+    if (!launcher->channel)
+        return DEFAULT_PREDICTIVE_WARMUP;
+    
+    return xfconf_channel_get_bool(launcher->channel, SETTING_PREDICTIVE_WARMUP,
+                                   DEFAULT_PREDICTIVE_WARMUP);
+}
+
+/* Upper bound on the file data one warm-up pass may read ahead */
+guint launcher_settings_get_warmup_budget_mb(LauncherPlugin *launcher) {
+    if (!launcher->channel)
+        return DEFAULT_WARMUP_BUDGET_MB;
+    
+    return xfconf_channel_get_uint(launcher->channel, SETTING_WARMUP_BUDGET_MB,
+                                   DEFAULT_WARMUP_BUDGET_MB);
+}
+
+/* Whether loading and the overlay wait until the panel is idle or the
+ * launcher is used */
+gboolean launcher_settings_get_lazy_startup(LauncherPlugin *launcher) {
+    if (!launcher->channel)
+        return DEFAULT_LAZY_STARTUP;
+    
+    return xfconf_channel_get_bool(launcher->channel, SETTING_LAZY_STARTUP,
+                                   DEFAULT_LAZY_STARTUP);
+}
+
+/* Whether entries drop their parsed desktop file once the fields the
+ * launcher shows are copied out */
+gboolean launcher_settings_get_memory_lean(LauncherPlugin *launcher) {
+    if (!launcher->channel)
+        return DEFAULT_MEMORY_LEAN;
+    
+    return xfconf_channel_get_bool(launcher->channel, SETTING_MEMORY_LEAN,
+                                   DEFAULT_MEMORY_LEAN);
+}
+
+/* Whether the overlay scrolls through one list instead of showing pages */
+gboolean launcher_settings_get_continuous_scroll(LauncherPlugin *launcher) {
+    if (!launcher->channel)
+        return DEFAULT_CONTINUOUS_SCROLL;
+    
+    return xfconf_channel_get_bool(launcher->channel, SETTING_CONTINUOUS_SCROLL,
+                                   DEFAULT_CONTINUOUS_SCROLL);
+}
+
 /* Helper to create icon list store with larger icons */
 static GtkListStore* create_icon_store(void) {
     GtkListStore *store;
@@ -345,6 +401,25 @@ static void on_icon_button_clicked(GtkWidget *button, LauncherPlugin *launcher)
     gtk_widget_destroy(dialog);
 }
 
+/* Predictive warm-up toggled */
+static void on_warmup_toggled(GtkToggleButton *toggle, LauncherPlugin *launcher) {
+    gboolean active = gtk_toggle_button_get_active(toggle);
+    
+    if (launcher->channel)
+        xfconf_channel_set_bool(launcher->channel, SETTING_PREDICTIVE_WARMUP, active);
+    
+    /* The warm-up thread is started again by the next warm-up */
+    if (!active)
+        prewarm_disable(launcher->catalog);
+}
+
+/* Continuous scrolling toggled, applies the next time the launcher opens */
+static void on_continuous_scroll_toggled(GtkToggleButton *toggle, LauncherPlugin *launcher) {
+    if (launcher->channel)
+        xfconf_channel_set_bool(launcher->channel, SETTING_CONTINUOUS_SCROLL,
+                                gtk_toggle_button_get_active(toggle));
+}
+
 /* Reset icon to default */
 static void on_reset_clicked(GtkWidget *button, gpointer data) {
     LauncherPlugin *launcher = (LauncherPlugin *)data;
@@ -364,6 +439,8 @@ void launcher_show_settings_dialog(LauncherPlugin *launcher) {
     GtkWidget *icon_button;
     GtkWidget *icon_image;
     GtkWidget *reset_button;
+    GtkWidget *warmup_check;
+    GtkWidget *scroll_check;
     gchar *current_icon;
     
     /* Create dialog */
@@ -423,6 +500,28 @@ void launcher_show_settings_dialog(LauncherPlugin *launcher) {
     g_signal_connect(reset_button, "clicked",
                      G_CALLBACK(on_reset_clicked), launcher);
     
+    /* Predictive warm-up, off by default */
+    warmup_check = gtk_check_button_new_with_label("Warm up frequently launched applications");
+    gtk_widget_set_tooltip_text(warmup_check,
+                                "Read likely applications into memory in the background "
+                                "while the launcher is open, so they start faster");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(warmup_check),
+                                 launcher_settings_get_predictive_warmup(launcher));
+    gtk_box_pack_start(GTK_BOX(vbox), warmup_check, FALSE, FALSE, 0);
+    g_signal_connect(warmup_check, "toggled",
+                     G_CALLBACK(on_warmup_toggled), launcher);
+    
+    /* Continuous scrolling, pages by default */
+    scroll_check = gtk_check_button_new_with_label("Scroll through all applications instead of pages");
+    gtk_widget_set_tooltip_text(scroll_check,
+                                "Show every application in one list that scrolls vertically, "
+                                "for large numbers of applications");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(scroll_check),
+                                 launcher_settings_get_continuous_scroll(launcher));
+    gtk_box_pack_start(GTK_BOX(vbox), scroll_check, FALSE, FALSE, 0);
+    g_signal_connect(scroll_check, "toggled",
+                     G_CALLBACK(on_continuous_scroll_toggled), launcher);
+    
     /* Show dialog */
     gtk_widget_show_all(dialog);
     
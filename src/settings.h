@@ -35,15 +35,33 @@
 /* Settings property names */
 #define XFCE_LAUNCHER_CHANNEL_NAME "xfce4-panel-launcher"
 #define SETTING_ICON_NAME "/icon-name"
+#define SETTING_MONITOR_QUIET_MS "/monitor-quiet-ms"
+#define SETTING_PREDICTIVE_WARMUP "/predictive-warmup"
+#define SETTING_WARMUP_BUDGET_MB "/warmup-budget-mb"
+#define SETTING_LAZY_STARTUP "/lazy-startup"
+#define SETTING_MEMORY_LEAN "/memory-lean"
+#define SETTING_CONTINUOUS_SCROLL "/continuous-scroll"
 
 /* Default values */
 #define DEFAULT_ICON_NAME "xfce-launcher"
+#define DEFAULT_MONITOR_QUIET_MS 500
+#define DEFAULT_PREDICTIVE_WARMUP FALSE
+#define DEFAULT_WARMUP_BUDGET_MB 256
+#define DEFAULT_LAZY_STARTUP TRUE
+#define DEFAULT_MEMORY_LEAN FALSE
+#define DEFAULT_CONTINUOUS_SCROLL FALSE
 
 /* Settings functions */
 void launcher_settings_init(LauncherPlugin *launcher);
 void launcher_settings_free(LauncherPlugin *launcher);
 gchar* launcher_settings_get_icon_name(LauncherPlugin *launcher);
 void launcher_settings_set_icon_name(LauncherPlugin *launcher, const gchar *icon_name);
+guint launcher_settings_get_monitor_quiet_ms(LauncherPlugin *launcher);
+gboolean launcher_settings_get_predictive_warmup(LauncherPlugin *launcher);
+guint launcher_settings_get_warmup_budget_mb(LauncherPlugin *launcher);
+gboolean launcher_settings_get_lazy_startup(LauncherPlugin *launcher);
+gboolean launcher_settings_get_memory_lean(LauncherPlugin *launcher);
+gboolean launcher_settings_get_continuous_scroll(LauncherPlugin *launcher);
 void launcher_show_settings_dialog(LauncherPlugin *launcher);
 
 #endif /* XFCE_LAUNCHER_SETTINGS_H */
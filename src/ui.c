@@ -21,19 +21,29 @@
 
 #include "xfce-launcher.h"
 
+static void create_recent_tiles(LauncherPlugin *launcher);
+
 void create_overlay_window(LauncherPlugin *launcher) {
     GtkWidget *main_box, *search_box, *grid_container, *center_box;
     GdkScreen *screen;
     GdkVisual *visual;
+    gint monitor_num;
+    gint64 start = trace_begin();
+    
+    /* Laid out for the monitor it opens on */
+    launcher->geometry = *grid_geometry_for_view(launcher, &monitor_num);
     
     launcher->overlay_window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
     gtk_window_set_type_hint(GTK_WINDOW(launcher->overlay_window), GDK_WINDOW_TYPE_HINT_DIALOG);
     gtk_window_set_decorated(GTK_WINDOW(launcher->overlay_window), FALSE);
     gtk_window_set_skip_taskbar_hint(GTK_WINDOW(launcher->overlay_window), TRUE);
     gtk_window_set_skip_pager_hint(GTK_WINDOW(launcher->overlay_window), TRUE);
-    gtk_window_fullscreen(GTK_WINDOW(launcher->overlay_window));
     
     screen = gtk_widget_get_screen(launcher->overlay_window);
+    if (monitor_num >= 0)
+        gtk_window_fullscreen_on_monitor(GTK_WINDOW(launcher->overlay_window), screen, monitor_num);
+    else
+        gtk_window_fullscreen(GTK_WINDOW(launcher->overlay_window));
     visual = gdk_screen_get_rgba_visual(screen);
     if (visual && gdk_screen_is_composited(screen)) {
         gtk_widget_set_visual(launcher->overlay_window, visual);
@@ -70,28 +80,53 @@ void create_overlay_window(LauncherPlugin *launcher) {
     g_signal_connect(launcher->search_entry, "search-changed",
                      G_CALLBACK(on_search_changed), launcher);
 
-    center_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
-    gtk_widget_set_halign(center_box, GTK_ALIGN_CENTER);
-    gtk_widget_set_valign(center_box, GTK_ALIGN_CENTER);
-    gtk_box_pack_start(GTK_BOX(main_box), center_box, TRUE, TRUE, 0);
+    /* Most used applications, above the pages */
+    launcher->recent_row = gtk_grid_new();
+    gtk_grid_set_column_spacing(GTK_GRID(launcher->recent_row), launcher->geometry.spacing);
+    gtk_widget_set_halign(launcher->recent_row, GTK_ALIGN_CENTER);
+    gtk_style_context_add_class(gtk_widget_get_style_context(launcher->recent_row), "recent-row");
+    gtk_widget_set_no_show_all(launcher->recent_row, TRUE);
+    gtk_box_pack_start(GTK_BOX(main_box), launcher->recent_row, FALSE, FALSE, 0);
+    create_recent_tiles(launcher);
 
-    grid_container = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
-    gtk_box_pack_start(GTK_BOX(center_box), grid_container, FALSE, FALSE, 0);
+    launcher->grid_area = gtk_overlay_new();
+    gtk_box_pack_start(GTK_BOX(main_box), launcher->grid_area, TRUE, TRUE, 0);
 
     launcher->app_grid = gtk_grid_new();
-    gtk_grid_set_row_spacing(GTK_GRID(launcher->app_grid), 20);
-    gtk_grid_set_column_spacing(GTK_GRID(launcher->app_grid), 20);
-    gtk_widget_set_halign(launcher->app_grid, GTK_ALIGN_CENTER);
-    gtk_widget_set_valign(launcher->app_grid, GTK_ALIGN_CENTER);
-    gtk_box_pack_start(GTK_BOX(grid_container), launcher->app_grid, FALSE, FALSE, 0);
+    gtk_grid_set_row_spacing(GTK_GRID(launcher->app_grid), launcher->geometry.spacing);
+    gtk_grid_set_column_spacing(GTK_GRID(launcher->app_grid), launcher->geometry.spacing);
+    create_tile_pool(launcher, launcher->app_grid, &launcher->app_tiles, &launcher->folder_tiles);
+
+    if (launcher->continuous_scroll) {
+        /* One list, only the rows in view have tiles */
+        scroll_view_new(launcher);
+        gtk_container_add(GTK_CONTAINER(launcher->grid_area), launcher->scrolled_window);
+    } else {
+        center_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
+        gtk_widget_set_halign(center_box, GTK_ALIGN_CENTER);
+        gtk_widget_set_valign(center_box, GTK_ALIGN_CENTER);
+        gtk_container_add(GTK_CONTAINER(launcher->grid_area), center_box);
+
+        grid_container = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
+        gtk_box_pack_start(GTK_BOX(center_box), grid_container, FALSE, FALSE, 0);
+
+        gtk_widget_set_halign(launcher->app_grid, GTK_ALIGN_CENTER);
+        gtk_widget_set_valign(launcher->app_grid, GTK_ALIGN_CENTER);
+        gtk_box_pack_start(GTK_BOX(grid_container), launcher->app_grid, FALSE, FALSE, 0);
+    }
 
     launcher->page_dots = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
     gtk_widget_set_halign(launcher->page_dots, GTK_ALIGN_CENTER);
     gtk_style_context_add_class(gtk_widget_get_style_context(launcher->page_dots), "page-dots");
     gtk_box_pack_start(GTK_BOX(main_box), launcher->page_dots, FALSE, FALSE, 0);
 
+    /* Page transitions have nothing to slide between in one list */
+    if (!launcher->continuous_scroll)
+        page_cache_new(launcher);
+
     populate_current_page(launcher);
     update_page_dots(launcher);
+    page_cache_prerender(launcher);
 
     g_signal_connect(launcher->overlay_window, "key-press-event",
                      G_CALLBACK(on_key_press), launcher);
@@ -104,6 +139,7 @@ void create_overlay_window(LauncherPlugin *launcher) {
                                              GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
 
     g_object_unref(provider);
+    trace_end(TRACE_CREATE_OVERLAY, start);
 }
 
 void hide_overlay(LauncherPlugin *launcher) {
@@ -111,135 +147,397 @@ void hide_overlay(LauncherPlugin *launcher) {
         gtk_widget_hide(launcher->overlay_window);
         gtk_entry_set_text(GTK_ENTRY(launcher->search_entry), "");
 
-        if (launcher->filtered_list) {
-            g_list_free(launcher->filtered_list);
-        }
-        launcher->filtered_list = g_list_copy(launcher->app_list);
+        catalog_fill_view(launcher);
         launcher->current_page = 0;
+        scroll_view_reset(launcher);
     }
+    
+    trace_export();
 }
 
-void populate_current_page(LauncherPlugin *launcher) {
-    GList *iter;
-    gint row, col;
-    gint start_index = launcher->current_page * APPS_PER_PAGE;
-    gint grid_index = 0;
+/* Tear the overlay down, the next open builds it again */
+void destroy_overlay_window(LauncherPlugin *launcher) {
+    if (!launcher->overlay_window)
+        return;
+    
+    /* Page surfaces and the off-screen renderer */
+    page_cache_free(launcher);
+    scroll_view_free(launcher);
+    
+    gtk_widget_destroy(launcher->overlay_window);
+    launcher->overlay_window = NULL;
+    launcher->search_entry = NULL;
+    launcher->back_button = NULL;
+    launcher->recent_row = NULL;
+    launcher->grid_area = NULL;
+    launcher->app_grid = NULL;
+    launcher->scrolled_window = NULL;
+    launcher->page_dots = NULL;
+    
+    /* The tiles went with the window */
+    g_clear_pointer(&launcher->app_tiles, g_ptr_array_unref);
+    g_clear_pointer(&launcher->folder_tiles, g_ptr_array_unref);
+    g_clear_pointer(&launcher->recent_tiles, g_ptr_array_unref);
+}
 
-    gtk_container_foreach(GTK_CONTAINER(launcher->app_grid),
-                         (GtkCallback)gtk_widget_destroy, NULL);
+/* A grid tile that is built once and rebound to different entries.
+ * Signal handlers are connected to the tile and look up what it shows. */
+typedef struct {
+    LauncherPlugin *launcher;
+    GtkWidget *grid;
+    GtkWidget *button;
+    GtkWidget *icon;
+    GtkWidget *label;
+    cairo_surface_t *icon_surface;
+    AppInfo *app_info;
+    FolderInfo *folder_info;
+    gint slot;                  /* index in its pool */
+    gint cell;                  /* grid cell, or < 0 while parked */
+} GridTile;
+
+static void on_tile_clicked(GtkWidget *button, GridTile *tile) {
+    if (tile->folder_info)
+        on_folder_clicked(button, tile->folder_info);
+    else if (tile->app_info)
+        launch_application(button, tile->app_info);
+}
 
-    /* Display folders */
-    for (iter = launcher->folder_list; iter != NULL; iter = g_list_next(iter)) {
-        FolderInfo *folder_info = (FolderInfo *)iter->data;
+static gboolean on_tile_button_press(GtkWidget *widget, GdkEventButton *event, GridTile *tile) {
+    if (!tile->app_info)
+        return FALSE;
+    
+    return on_button_press_event(widget, event, tile->app_info);
+}
+
+static void on_tile_drag_data_get(GtkWidget *widget, GdkDragContext *context, GtkSelectionData *data,
+                                  guint info, guint time, GridTile *tile) {
+    on_drag_data_get(widget, context, data, info, time, tile->app_info);
+}
+
+static void grid_tile_free(GridTile *tile) {
+    if (tile->icon_surface)
+        cairo_surface_destroy(tile->icon_surface);
+    g_free(tile);
+}
 
-        col = grid_index % GRID_COLUMNS;
-        row = grid_index / GRID_COLUMNS;
+static GridTile* grid_tile_new(LauncherPlugin *launcher, GtkWidget *grid, gboolean is_folder, gint slot) {
+    GridTile *tile = g_new0(GridTile, 1);
+    GtkWidget *box;
+    
+    tile->launcher = launcher;
+    tile->grid = grid;
+    tile->slot = slot;
+    
+    tile->button = gtk_button_new();
+    gtk_style_context_add_class(gtk_widget_get_style_context(tile->button),
+                                is_folder ? "folder" : "app-button");
+    gtk_button_set_relief(GTK_BUTTON(tile->button), GTK_RELIEF_NONE);
+    gtk_widget_set_size_request(tile->button, launcher->geometry.button_size,
+                                launcher->geometry.button_size);
+    gtk_widget_set_no_show_all(tile->button, TRUE);
+    
+    box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
+    gtk_container_add(GTK_CONTAINER(tile->button), box);
+    
+    tile->icon = gtk_image_new();
+    gtk_image_set_pixel_size(GTK_IMAGE(tile->icon), launcher->geometry.icon_size);
+    gtk_box_pack_start(GTK_BOX(box), tile->icon, FALSE, FALSE, 0);
+    
+    tile->label = gtk_label_new(NULL);
+    if (!is_folder) {
+        gtk_label_set_line_wrap(GTK_LABEL(tile->label), TRUE);
+        gtk_label_set_ellipsize(GTK_LABEL(tile->label), PANGO_ELLIPSIZE_END);
+        gtk_label_set_max_width_chars(GTK_LABEL(tile->label), 15);
+        gtk_label_set_lines(GTK_LABEL(tile->label), 2);
+    }
+    gtk_box_pack_start(GTK_BOX(box), tile->label, FALSE, FALSE, 0);
+    gtk_widget_show_all(box);
+    
+    g_signal_connect(tile->button, "clicked", G_CALLBACK(on_tile_clicked), tile);
+    
+    if (!is_folder) {
+        gtk_drag_source_set(tile->button, GDK_BUTTON1_MASK, NULL, 0, GDK_ACTION_MOVE);
+        gtk_drag_dest_set(tile->button, GTK_DEST_DEFAULT_ALL, NULL, 0, GDK_ACTION_MOVE);
+        g_signal_connect(tile->button, "drag-data-received",
+                        G_CALLBACK(on_drag_data_received), launcher);
+        g_signal_connect(tile->button, "drag-data-get",
+                        G_CALLBACK(on_tile_drag_data_get), tile);
+        g_signal_connect(tile->button, "drag-begin",
+                        G_CALLBACK(on_drag_begin), launcher);
+        g_signal_connect(tile->button, "button-press-event",
+                        G_CALLBACK(on_tile_button_press), tile);
+    }
+    
+    g_object_set_data(G_OBJECT(tile->button), "launcher", launcher);
+    g_object_set_data_full(G_OBJECT(tile->button), "grid-tile", tile,
+                           (GDestroyNotify)grid_tile_free);
+    
+    /* Parked tiles sit outside the visible cells, one per cell so that
+     * gtk_grid_get_child_at() never finds an unbound tile */
+    tile->cell = -1 - slot;
+    gtk_grid_attach(GTK_GRID(grid), tile->button,
+                    tile->cell, is_folder ? -2 : -1, 1, 1);
+    
+    return tile;
+}
 
-        GtkWidget *button, *box, *icon, *label;
-        button = gtk_button_new();
-        gtk_style_context_add_class(gtk_widget_get_style_context(button), "folder");
-        gtk_button_set_relief(GTK_BUTTON(button), GTK_RELIEF_NONE);
-        gtk_widget_set_size_request(button, BUTTON_SIZE, BUTTON_SIZE);
+/* Pre-build the tiles of one page in grid */
+void create_tile_pool(LauncherPlugin *launcher, GtkWidget *grid,
+                      GPtrArray **app_tiles, GPtrArray **folder_tiles) {
+    *app_tiles = g_ptr_array_sized_new(launcher->geometry.apps_per_page);
+    *folder_tiles = g_ptr_array_new();
+    
+    for (gint i = 0; i < launcher->geometry.apps_per_page; i++)
+        g_ptr_array_add(*app_tiles, grid_tile_new(launcher, grid, FALSE, i));
+}
 
-        box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
-        gtk_container_add(GTK_CONTAINER(button), box);
+/* Tiles of the recent row only launch, they take no part in drag and drop */
+static void create_recent_tiles(LauncherPlugin *launcher) {
+    launcher->recent_tiles = g_ptr_array_sized_new(launcher->geometry.columns);
+    
+    for (gint i = 0; i < launcher->geometry.columns; i++) {
+        GridTile *tile = grid_tile_new(launcher, launcher->recent_row, FALSE, i);
+        
+        gtk_drag_source_unset(tile->button);
+        gtk_drag_dest_unset(tile->button);
+        g_ptr_array_add(launcher->recent_tiles, tile);
+    }
+}
 
-        icon = gtk_image_new_from_icon_name(folder_info->icon, GTK_ICON_SIZE_DIALOG);
-        gtk_image_set_pixel_size(GTK_IMAGE(icon), ICON_SIZE);
-        gtk_box_pack_start(GTK_BOX(box), icon, FALSE, FALSE, 0);
+/* Whether app gets a tile in the current view, folders and search aside */
+gboolean app_is_listed(LauncherPlugin *launcher, AppInfo *app_info) {
+    if (!app_info->name)
+        return FALSE;
+    
+    return launcher->open_folder != NULL || (!app_info->is_hidden && !app_info->folder_id);
+}
 
-        label = gtk_label_new(folder_info->name);
-        gtk_box_pack_start(GTK_BOX(box), label, FALSE, FALSE, 0);
+static GridTile* get_tile(LauncherPlugin *launcher, GtkWidget *grid, GPtrArray *pool,
+                          gboolean is_folder, guint slot) {
+    /* Only an open folder or a tall scroll view can need more than one
+     * page of tiles */
+    if (slot >= pool->len)
+        g_ptr_array_add(pool, grid_tile_new(launcher, grid, is_folder, slot));
+    
+    return g_ptr_array_index(pool, slot);
+}
 
-        g_signal_connect(button, "clicked", G_CALLBACK(on_folder_clicked), folder_info);
-        gtk_grid_attach(GTK_GRID(launcher->app_grid), button, col, row, 1, 1);
-        g_object_set_data(G_OBJECT(button), "folder-info", folder_info);
-        g_object_set_data(G_OBJECT(button), "launcher", launcher);
-        gtk_widget_show_all(button);
-        grid_index++;
+static void place_tile(GridTile *tile, gint cell, gint top_if_parked) {
+    gint columns = tile->launcher->geometry.columns;
+    
+    if (tile->cell == cell)
+        return;
+    
+    tile->cell = cell;
+    if (cell >= 0) {
+        gtk_container_child_set(GTK_CONTAINER(tile->grid), tile->button,
+                                "left-attach", cell % columns,
+                                "top-attach", cell / columns, NULL);
+    } else {
+        gtk_container_child_set(GTK_CONTAINER(tile->grid), tile->button,
+                                "left-attach", cell, "top-attach", top_if_parked, NULL);
     }
+}
 
-    /* Display applications */
-    GList *apps_to_display = launcher->open_folder ? launcher->open_folder->apps : launcher->filtered_list;
-    for (iter = apps_to_display; iter != NULL; iter = g_list_next(iter)) {
-        AppInfo *app_info = (AppInfo *)iter->data;
+static void set_tile_content(GridTile *tile, const gchar *icon_name, const gchar *text) {
+    gint size = tile->launcher->geometry.icon_size;
+    gint scale = gtk_widget_get_scale_factor(tile->button);
+    cairo_surface_t *surface = icon_cache_lookup(tile->launcher, icon_name, size, scale);
+    
+    if (!surface)
+        surface = icon_cache_lookup(tile->launcher, "application-x-executable", size, scale);
+    
+    /* Skip the image update when the tile already shows this icon */
+    if (surface && surface != tile->icon_surface) {
+        gtk_image_set_from_surface(GTK_IMAGE(tile->icon), surface);
+        if (tile->icon_surface)
+            cairo_surface_destroy(tile->icon_surface);
+        tile->icon_surface = cairo_surface_reference(surface);
+    } else if (!surface) {
+        gtk_image_set_from_icon_name(GTK_IMAGE(tile->icon), icon_name, GTK_ICON_SIZE_DIALOG);
+        g_clear_pointer(&tile->icon_surface, cairo_surface_destroy);
+    }
+    
+    if (g_strcmp0(gtk_label_get_text(GTK_LABEL(tile->label)), text) != 0)
+        gtk_label_set_text(GTK_LABEL(tile->label), text);
+}
+
+static void bind_app_tile(GridTile *tile, AppInfo *app_info, gint cell) {
+    tile->app_info = app_info;
+    g_object_set_data(G_OBJECT(tile->button), "app-info", app_info);
+    set_tile_content(tile, app_info->icon ? app_info->icon : "application-x-executable",
+                     app_info->name);
+    place_tile(tile, cell, -1);
+    gtk_widget_show(tile->button);
+}
+
+static void bind_folder_tile(GridTile *tile, FolderInfo *folder_info, gint cell) {
+    tile->folder_info = folder_info;
+    g_object_set_data(G_OBJECT(tile->button), "folder-info", folder_info);
+    set_tile_content(tile, folder_info->icon, folder_info->name);
+    place_tile(tile, cell, -2);
+    gtk_widget_show(tile->button);
+}
 
-        if (launcher->open_folder == NULL && (app_info->is_hidden || app_info->folder_id)) {
+static void park_tiles(GPtrArray *pool, guint from, gint top) {
+    for (guint i = from; i < pool->len; i++) {
+        GridTile *tile = g_ptr_array_index(pool, i);
+        
+        if (tile->cell < 0)
             continue;
-        }
+        
+        gtk_widget_hide(tile->button);
+        tile->app_info = NULL;
+        tile->folder_info = NULL;
+        g_object_set_data(G_OBJECT(tile->button), "app-info", NULL);
+        g_object_set_data(G_OBJECT(tile->button), "folder-info", NULL);
+        place_tile(tile, -1 - tile->slot, top);
+    }
+}
+
+/* Bind the tiles of grid to the entries of page */
+void populate_grid(LauncherPlugin *launcher, GtkWidget *grid,
+                   GPtrArray *app_tiles, GPtrArray *folder_tiles, gint page) {
+    GList *iter;
+    GPtrArray *apps;
+    gint apps_per_page = launcher->geometry.apps_per_page;
+    gint start_index = page * apps_per_page;
+    guint first, last;
+    guint n_folders = 0, n_apps = 0;
 
-        if (grid_index >= start_index && (launcher->open_folder != NULL || grid_index < start_index + APPS_PER_PAGE)) {
-            GtkWidget *button, *box, *icon, *label;
-
-            col = grid_index % GRID_COLUMNS;
-            row = grid_index / GRID_COLUMNS;
-
-            button = gtk_button_new();
-            gtk_style_context_add_class(gtk_widget_get_style_context(button), "app-button");
-            gtk_button_set_relief(GTK_BUTTON(button), GTK_RELIEF_NONE);
-            gtk_widget_set_size_request(button, BUTTON_SIZE, BUTTON_SIZE);
-
-            box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
-            gtk_container_add(GTK_CONTAINER(button), box);
-
-            if (app_info->icon) {
-                icon = gtk_image_new_from_icon_name(app_info->icon, GTK_ICON_SIZE_DIALOG);
-                gtk_image_set_pixel_size(GTK_IMAGE(icon), ICON_SIZE);
-            } else {
-                icon = gtk_image_new_from_icon_name("application-x-executable", GTK_ICON_SIZE_DIALOG);
-                gtk_image_set_pixel_size(GTK_IMAGE(icon), ICON_SIZE);
-            }
-            gtk_box_pack_start(GTK_BOX(box), icon, FALSE, FALSE, 0);
-
-            if (app_info->name) {
-                label = gtk_label_new(app_info->name);
-            } else {
-                continue;
-            }
-            gtk_label_set_line_wrap(GTK_LABEL(label), TRUE);
-            gtk_label_set_ellipsize(GTK_LABEL(label), PANGO_ELLIPSIZE_END);
-            gtk_label_set_max_width_chars(GTK_LABEL(label), 15);
-            gtk_label_set_lines(GTK_LABEL(label), 2);
-            gtk_box_pack_start(GTK_BOX(box), label, FALSE, FALSE, 0);
-
-            gtk_drag_source_set(button, GDK_BUTTON1_MASK, NULL, 0, GDK_ACTION_MOVE);
-            gtk_drag_dest_set(button, GTK_DEST_DEFAULT_ALL, NULL, 0, GDK_ACTION_MOVE);
-            g_signal_connect(button, "drag-data-received",
-                            G_CALLBACK(on_drag_data_received), launcher);
-            g_signal_connect(button, "drag-data-get",
-                            G_CALLBACK(on_drag_data_get), app_info);
-
-            g_signal_connect(button, "drag-begin",
-                            G_CALLBACK(on_drag_begin), launcher);
-
-            g_signal_connect(button, "button-press-event",
-                            G_CALLBACK(on_button_press_event), app_info);
-
-            g_signal_connect(button, "clicked",
-                            G_CALLBACK(launch_application), app_info);
-
-            gtk_grid_attach(GTK_GRID(launcher->app_grid), button, col, row, 1, 1);
-
-            g_object_set_data(G_OBJECT(button), "app-info", app_info);
-            g_object_set_data(G_OBJECT(button), "launcher", launcher);
-
-            gtk_widget_show_all(button);
+    /* Display folders */
+    for (iter = launcher->catalog->folder_list; iter != NULL; iter = g_list_next(iter)) {
+        FolderInfo *folder_info = (FolderInfo *)iter->data;
+        GridTile *tile = get_tile(launcher, grid, folder_tiles, TRUE, n_folders);
+
+        bind_folder_tile(tile, folder_info, n_folders);
+        n_folders++;
+    }
+
+    /* Display applications: every entry is listed, so the page is a slice
+     * after the folders. An open folder shows all of its entries. */
+    apps = launcher->open_folder ? launcher->open_folder->apps : launcher->filtered;
+    first = MIN((guint)MAX(start_index - (gint)n_folders, 0), apps->len);
+    last = launcher->open_folder ? apps->len :
+           MIN((guint)MAX(start_index + apps_per_page - (gint)n_folders, 0), apps->len);
+    for (guint i = first; i < last; i++) {
+        GridTile *tile = get_tile(launcher, grid, app_tiles, FALSE, n_apps);
+
+        bind_app_tile(tile, g_ptr_array_index(apps, i), n_folders + n_apps);
+        n_apps++;
+    }
+
+    park_tiles(folder_tiles, n_folders, -2);
+    park_tiles(app_tiles, n_apps, -1);
+}
+
+/* Bind the tiles of grid to count entries from first on, in one list of
+ * the folders followed by the applications */
+void populate_grid_range(LauncherPlugin *launcher, GtkWidget *grid,
+                         GPtrArray *app_tiles, GPtrArray *folder_tiles,
+                         guint first, guint count) {
+    GPtrArray *apps = launcher->open_folder ? launcher->open_folder->apps : launcher->filtered;
+    guint n_folders = g_list_length(launcher->catalog->folder_list);
+    guint end = MIN(first + count, n_folders + apps->len);
+    GList *iter = g_list_nth(launcher->catalog->folder_list, first);
+    guint n_folder_tiles = 0, n_app_tiles = 0;
+    
+    for (guint i = first; i < end; i++) {
+        gint cell = i - first;
+        
+        if (i < n_folders) {
+            GridTile *tile = get_tile(launcher, grid, folder_tiles, TRUE, n_folder_tiles++);
+            
+            bind_folder_tile(tile, iter->data, cell);
+            iter = g_list_next(iter);
+        } else {
+            GridTile *tile = get_tile(launcher, grid, app_tiles, FALSE, n_app_tiles++);
+            
+            bind_app_tile(tile, g_ptr_array_index(apps, i - n_folders), cell);
         }
-        grid_index++;
     }
+    
+    park_tiles(folder_tiles, n_folder_tiles, -2);
+    park_tiles(app_tiles, n_app_tiles, -1);
+}
+
+void populate_current_page(LauncherPlugin *launcher) {
+    gint64 start;
+    
+    /* The overlay is built on first open */
+    if (!launcher->app_grid)
+        return;
+    
+    start = trace_begin();
+    if (launcher->scroll_view)
+        scroll_view_populate(launcher);
+    else
+        populate_grid(launcher, launcher->app_grid, launcher->app_tiles,
+                      launcher->folder_tiles, launcher->current_page);
+    populate_recent_row(launcher);
+    trace_end(TRACE_POPULATE_PAGE, start);
+}
+
+/* Show the highest frecency applications, unless searching or in a folder */
+void populate_recent_row(LauncherPlugin *launcher) {
+    const gchar *search_text;
+    GList *recent, *iter;
+    guint n_apps = 0;
+    
+    if (!launcher->recent_row)
+        return;
+    
+    search_text = gtk_entry_get_text(GTK_ENTRY(launcher->search_entry));
+    if (launcher->open_folder || (search_text && *search_text)) {
+        /* Unbound, the entries may go away while the row is hidden */
+        park_tiles(launcher->recent_tiles, 0, -1);
+        gtk_widget_hide(launcher->recent_row);
+        return;
+    }
+    
+    recent = launch_history_top(launcher, launcher->geometry.columns);
+    for (iter = recent; iter != NULL; iter = g_list_next(iter)) {
+        GridTile *tile = get_tile(launcher, launcher->recent_row, launcher->recent_tiles, FALSE, n_apps);
+        
+        bind_app_tile(tile, iter->data, n_apps);
+        n_apps++;
+    }
+    park_tiles(launcher->recent_tiles, n_apps, -1);
+    g_list_free(recent);
+    
+    gtk_widget_set_visible(launcher->recent_row, n_apps > 0);
+}
+
+/* Index one past the last entry the current page or scroll position can
+ * show; changes before it show up in the view */
+guint view_get_end_index(LauncherPlugin *launcher) {
+    if (launcher->scroll_view)
+        return scroll_view_get_end_index(launcher);
+    return (launcher->current_page + 1) * launcher->geometry.apps_per_page;
 }
 
 void update_page_dots(LauncherPlugin *launcher) {
     GList *children, *iter;
     gint i;
 
+    if (!launcher->page_dots)
+        return;
+
     children = gtk_container_get_children(GTK_CONTAINER(launcher->page_dots));
     for (iter = children; iter != NULL; iter = g_list_next(iter)) {
         gtk_widget_destroy(GTK_WIDGET(iter->data));
     }
     g_list_free(children);
 
-    launcher->total_pages = (g_list_length(launcher->filtered_list) + APPS_PER_PAGE - 1) / APPS_PER_PAGE;
+    /* A scroll view is one page as tall as the list */
+    if (launcher->scroll_view) {
+        launcher->total_pages = 1;
+        scroll_view_update_extent(launcher);
+        return;
+    }
+
+    launcher->total_pages = (launcher->filtered->len + launcher->geometry.apps_per_page - 1) /
+                            launcher->geometry.apps_per_page;
 
     for (i = 0; i < launcher->total_pages; i++) {
         GtkWidget *dot = gtk_button_new();
@@ -258,6 +556,35 @@ void update_page_dots(LauncherPlugin *launcher) {
     }
 }
 
+/* Sizes in get_css_style() that the grid geometry depends on, see
+ * get_tile_margin() and get_chrome_height() */
+#define CSS_TILE_MARGIN         10
+#define CSS_SEARCH_MARGIN       40
+#define CSS_SEARCH_BORDER       1
+#define CSS_ENTRY_FONT_SIZE     18
+#define CSS_ENTRY_PADDING_Y     16
+#define CSS_RECENT_ROW_MARGIN   10
+#define CSS_PAGE_DOTS_PADDING   30
+#define CSS_PAGE_DOT_SIZE       8
+#define CSS_PAGE_DOT_PADDING    4
+
+/* Margin around every tile */
+gint get_tile_margin(void) {
+    return CSS_TILE_MARGIN;
+}
+
+/* Height of the search field, the recent row's rule and the page dots,
+ * which the grid rows share the workarea with. A line of entry text is
+ * taken as 1.25 times the font size. */
+gint get_chrome_height(void) {
+    gint search = 2 * CSS_SEARCH_MARGIN + 2 * CSS_SEARCH_BORDER +
+                  2 * CSS_ENTRY_PADDING_Y + CSS_ENTRY_FONT_SIZE * 5 / 4;
+    gint recent = CSS_RECENT_ROW_MARGIN + 1;
+    gint dots = 2 * CSS_PAGE_DOTS_PADDING + CSS_PAGE_DOT_SIZE + 2 * CSS_PAGE_DOT_PADDING;
+    
+    return search + recent + dots;
+}
+
 const gchar* get_css_style(void) {
     return
     "window {\n"
@@ -268,7 +595,7 @@ const gchar* get_css_style(void) {
     "  background-image: none;\n"
     "  border: none;\n"
     "  padding: 15px;\n"
-    "  margin: 10px;\n"
+    "  margin: " G_STRINGIFY(CSS_TILE_MARGIN) "px;\n"
     "  border-radius: 16px;\n"
     "}\n"
     "button.app-button:hover {\n"
@@ -288,15 +615,15 @@ const gchar* get_css_style(void) {
     ".search-container {\n"
     "  background-color: rgba(255, 255, 255, 0.15);\n"
     "  border-radius: 12px;\n"
-    "  border: 1px solid rgba(255, 255, 255, 0.2);\n"
-    "  margin: 40px;\n"
+    "  border: " G_STRINGIFY(CSS_SEARCH_BORDER) "px solid rgba(255, 255, 255, 0.2);\n"
+    "  margin: " G_STRINGIFY(CSS_SEARCH_MARGIN) "px;\n"
     "}\n"
     "entry {\n"
     "  background-color: transparent;\n"
     "  background-image: none;\n"
     "  border: none;\n"
-    "  font-size: 18px;\n"
-    "  padding: 16px 20px;\n"
+    "  font-size: " G_STRINGIFY(CSS_ENTRY_FONT_SIZE) "px;\n"
+    "  padding: " G_STRINGIFY(CSS_ENTRY_PADDING_Y) "px 20px;\n"
     "  color: white;\n"
     "  caret-color: white;\n"
     "  font-weight: 300;\n"
@@ -311,18 +638,22 @@ const gchar* get_css_style(void) {
     "  background-color: rgba(255, 255, 255, 0.3);\n"
     "  color: white;\n"
     "}\n"
+    "grid.recent-row {\n"
+    "  border-bottom: 1px solid rgba(255, 255, 255, 0.1);\n"
+    "  margin-bottom: " G_STRINGIFY(CSS_RECENT_ROW_MARGIN) "px;\n"
+    "}\n"
     "box.page-dots {\n"
-    "  padding: 30px;\n"
+    "  padding: " G_STRINGIFY(CSS_PAGE_DOTS_PADDING) "px;\n"
     "}\n"
     "button.page-dot {\n"
     "  background-color: rgba(255, 255, 255, 0.3);\n"
     "  background-image: none;\n"
     "  border: none;\n"
     "  border-radius: 50%;\n"
-    "  min-width: 8px;\n"
-    "  min-height: 8px;\n"
+    "  min-width: " G_STRINGIFY(CSS_PAGE_DOT_SIZE) "px;\n"
+    "  min-height: " G_STRINGIFY(CSS_PAGE_DOT_SIZE) "px;\n"
     "  margin: 0px 5px;\n"
-    "  padding: 4px;\n"
+    "  padding: " G_STRINGIFY(CSS_PAGE_DOT_PADDING) "px;\n"
     "}\n"
     "button.page-dot.active {\n"
     "  background-color: rgba(255, 255, 255, 0.9);\n"
@@ -335,7 +666,7 @@ const gchar* get_css_style(void) {
     "  background-image: none;\n"
     "  border: none;\n"
     "  padding: 15px;\n"
-    "  margin: 10px;\n"
+    "  margin: " G_STRINGIFY(CSS_TILE_MARGIN) "px;\n"
     "  border-radius: 16px;\n"
     "}\n"
     "button.folder:hover {\n"
@@ -37,15 +37,34 @@
 
 /* Forward declarations */
 typedef struct _LauncherPlugin LauncherPlugin;
+typedef struct _Catalog Catalog;
 typedef struct _AppInfo AppInfo;
 typedef struct _FolderInfo FolderInfo;
+typedef struct _AppLoader AppLoader;
+typedef struct _MonitorQueue MonitorQueue;
+typedef struct _AppScan AppScan;
+typedef struct _PageCache PageCache;
+typedef struct _ScrollView ScrollView;
+typedef struct _IconCache IconCache;
+typedef struct _IconAtlas IconAtlas;
+typedef struct _SearchIndex SearchIndex;
+typedef struct _LaunchHistory LaunchHistory;
+typedef struct _Prewarm Prewarm;
+typedef struct _ConfigStore ConfigStore;
 
-/* Application info structure */
+/* Application info structure. The parsed strings share one block, see
+ * app_info_new(); icon and categories repeat a lot and are interned. */
 struct _AppInfo {
-    gchar *name;
-    gchar *exec;
-    gchar *icon;
-    GDesktopAppInfo *desktop_info;
+    const gchar *name;
+    const gchar *exec;
+    const gchar *icon;               /* interned */
+    const gchar *desktop_id;
+    const gchar *filename;
+    const gchar *generic_name;
+    const gchar *keywords;           /* space separated */
+    const gchar *categories;         /* as in the desktop file, ';' separated, interned */
+    gchar *strings;
+    GDesktopAppInfo *desktop_info;   /* NULL when loaded from cache or in memory-lean mode */
     gboolean is_hidden;
     gchar *folder_id;
     gint position;
@@ -56,23 +75,66 @@ struct _FolderInfo {
     gchar *id;
     gchar *name;
     gchar *icon;
-    GList *apps;
+    GPtrArray *apps;                 /* AppInfo owned by the catalog */
     gboolean is_open;
 };
 
-/* Plugin structure */
+/* Application catalog shared by every launcher instance in the process */
+struct _Catalog {
+    gint            ref_count;
+    GList           *views;           /* LauncherPlugin instances using the catalog */
+    GPtrArray       *apps;            /* AppInfo in display order, owns the entries */
+    GList           *folder_list;
+    GHashTable      *app_index;       /* desktop-id -> AppInfo in apps */
+    SearchIndex     *search_index;
+    IconCache       *icon_cache;
+    LaunchHistory   *history;
+    Prewarm         *prewarm;
+    AppLoader       *loader;
+    MonitorQueue    *monitor_queue;
+    AppScan         *app_scan;        /* stat data the list was read after, see application-cache.c */
+    ConfigStore     *config_store;    /* snapshot and journal writer, see config-store.c */
+    GHashTable      *geometries;      /* monitor configuration -> GridGeometry */
+    GQueue          *recent_desktop_info;  /* re-parsed GDesktopAppInfo, most recent first */
+    gboolean        memory_lean;      /* entries keep no GDesktopAppInfo */
+    gboolean        config_loaded;
+    gboolean        config_dirty;
+    gboolean        services_started;  /* loader, monitors and caches, see catalog.c */
+};
+
+/* Layout of the tile grid for one monitor configuration */
+typedef struct {
+    gint columns;
+    gint rows;
+    gint apps_per_page;
+    gint icon_size;
+    gint button_size;                /* tile size request, CSS margins aside */
+    gint spacing;                    /* between tiles */
+    gint scale;                      /* of the monitor, for icon surfaces */
+} GridGeometry;
+
+/* Plugin structure, one per panel instance */
 struct _LauncherPlugin {
     XfcePanelPlugin *plugin;
+    Catalog         *catalog;
     GtkWidget       *button;
     GtkWidget       *icon;
     GtkWidget       *overlay_window;
     GtkWidget       *search_entry;
     GtkWidget       *app_grid;
+    GPtrArray       *app_tiles;       /* recycled grid tiles, see ui.c */
+    GPtrArray       *folder_tiles;
+    GtkWidget       *recent_row;      /* frecency ranked "recent & frequent" tiles */
+    GPtrArray       *recent_tiles;
+    GtkWidget       *grid_area;       /* overlay holding the grid and page transitions */
+    PageCache       *page_cache;
     GtkWidget       *page_dots;
-    GtkWidget       *scrolled_window;
-    GList           *app_list;
-    GList           *filtered_list;
-    GList           *folder_list;
+    GtkWidget       *scrolled_window;  /* continuous scroll mode only */
+    ScrollView      *scroll_view;
+    gboolean        continuous_scroll; /* the mode the overlay was built in */
+    GridGeometry    geometry;          /* the overlay was built for */
+    GPtrArray       *filtered;        /* listed AppInfo in display order, owned by the catalog */
+    GCancellable    *launch_cancellable;  /* launches still in flight */
     FolderInfo      *open_folder;
     GtkWidget       *back_button;
     gint            current_page;
@@ -80,6 +142,8 @@ struct _LauncherPlugin {
     gboolean        drag_mode;
     AppInfo         *drag_source;
     XfconfChannel   *channel;
+    guint           startup_idle_id;
+    gint64          construct_time;
 };
 
 /* Helper structure for callbacks */
@@ -88,29 +152,185 @@ typedef struct {
     LauncherPlugin *launcher;
 } HideCallbackData;
 
-/* Constants */
-#define APPS_PER_PAGE 30
-#define GRID_COLUMNS 6
-#define GRID_ROWS 5
-#define ICON_SIZE 64
-#define BUTTON_SIZE 130
+/* Grid geometry, see geometry.c. The defaults hold where the monitor is
+ * not known. */
+#define DEFAULT_GRID_COLUMNS 6
+#define DEFAULT_GRID_ROWS 5
+#define DEFAULT_ICON_SIZE 64
+#define DEFAULT_BUTTON_SIZE 130
+#define DEFAULT_GRID_SPACING 20
+
+/* Subdirectory levels of an applications directory that are read and
+ * watched, the bound also keeps symlink loops out */
+#define APP_DIR_MAX_DEPTH 4
+
+/* Shared application catalog */
+void catalog_attach(LauncherPlugin *launcher);
+void catalog_detach(LauncherPlugin *launcher);
+void catalog_start_services(Catalog *catalog);
+LauncherPlugin* catalog_get_primary_view(Catalog *catalog);
+void catalog_refresh_views(Catalog *catalog, LauncherPlugin *except);
+void catalog_fill_view(LauncherPlugin *launcher);
+GDesktopAppInfo* catalog_lookup_desktop_info(Catalog *catalog, const gchar *desktop_id,
+                                             const gchar *filename);
+void catalog_remember_desktop_info(Catalog *catalog, GDesktopAppInfo *desktop_info);
+void catalog_forget_desktop_info(Catalog *catalog, const gchar *desktop_id);
 
 /* Application management functions */
-GList* load_applications(void);
-GList* load_applications_enhanced(void);
-void setup_application_monitoring(LauncherPlugin *launcher);
+GPtrArray* load_applications(void);
+GPtrArray* load_applications_enhanced(gboolean memory_lean);
+void load_applications_async(Catalog *catalog);
+void cancel_application_loading(Catalog *catalog);
+void rebuild_application_index(Catalog *catalog);
+void refresh_application_entries(Catalog *catalog, GList *desktop_ids);
+void setup_application_monitoring(Catalog *catalog);
+void stop_application_monitoring(Catalog *catalog);
+AppInfo* app_info_new(const gchar *name, const gchar *exec, const gchar *icon,
+                      const gchar *desktop_id, const gchar *filename,
+                      const gchar *generic_name, const gchar *keywords,
+                      const gchar *categories);
+void app_info_replace_strings(AppInfo *app_info, AppInfo *fresh);
 void free_app_info(AppInfo *app_info);
+GPtrArray* app_array_new(void);
+void app_array_insert_sorted(GPtrArray *apps, AppInfo *app_info, GCompareFunc compare);
+GDesktopAppInfo* app_info_get_desktop_info(Catalog *catalog, AppInfo *app_info);
+gchar* app_info_get_program(const AppInfo *app_info);
+gchar** get_application_dirs(void);
 gint compare_app_names(gconstpointer a, gconstpointer b);
+gint compare_app_positions(gconstpointer a, gconstpointer b);
+gint compare_app_name_entries(gconstpointer a, gconstpointer b);
+gint compare_app_position_entries(gconstpointer a, gconstpointer b);
 void launch_application(GtkWidget *button, AppInfo *app_info);
 void hide_application(AppInfo *app_info, LauncherPlugin *launcher);
 void recalculate_positions(LauncherPlugin *launcher);
 
+/* Application index cache */
+gchar* app_cache_get_path(void);
+GPtrArray* app_cache_load(AppScan **scan);
+void app_cache_save(GPtrArray *apps, AppScan *scan);
+void app_cache_save_async(GPtrArray *apps, AppScan *scan);
+AppScan* app_scan_new(gchar **search_path);
+AppScan* app_scan_copy(AppScan *scan);
+void app_scan_free(AppScan *scan);
+void app_scan_append(AppScan *dest, AppScan *src);
+gchar** app_scan_get_search_path(AppScan *scan);
+gchar** app_scan_get_dirs(AppScan *scan);
+gboolean app_scan_add_dir(AppScan *scan, const gchar *path);
+void app_scan_add_file(AppScan *scan, const gchar *path);
+void app_scan_restamp_dir(AppScan *scan, const gchar *path);
+
 /* UI functions */
 void create_overlay_window(LauncherPlugin *launcher);
 void hide_overlay(LauncherPlugin *launcher);
+void destroy_overlay_window(LauncherPlugin *launcher);
+void create_tile_pool(LauncherPlugin *launcher, GtkWidget *grid,
+                      GPtrArray **app_tiles, GPtrArray **folder_tiles);
+gboolean app_is_listed(LauncherPlugin *launcher, AppInfo *app_info);
+void populate_grid(LauncherPlugin *launcher, GtkWidget *grid,
+                   GPtrArray *app_tiles, GPtrArray *folder_tiles, gint page);
+void populate_grid_range(LauncherPlugin *launcher, GtkWidget *grid,
+                         GPtrArray *app_tiles, GPtrArray *folder_tiles,
+                         guint first, guint count);
 void populate_current_page(LauncherPlugin *launcher);
+guint view_get_end_index(LauncherPlugin *launcher);
+void populate_recent_row(LauncherPlugin *launcher);
 void update_page_dots(LauncherPlugin *launcher);
 const gchar* get_css_style(void);
+gint get_tile_margin(void);
+gint get_chrome_height(void);
+
+/* Page surface cache and transitions */
+void page_cache_new(LauncherPlugin *launcher);
+void page_cache_free(LauncherPlugin *launcher);
+void page_cache_invalidate(LauncherPlugin *launcher);
+void page_cache_prerender(LauncherPlugin *launcher);
+void show_page(LauncherPlugin *launcher, gint page);
+
+/* Grid geometry */
+const GridGeometry* grid_geometry_for_view(LauncherPlugin *launcher, gint *monitor_num);
+gboolean grid_geometry_equal(const GridGeometry *a, const GridGeometry *b);
+gint grid_geometry_get_pitch(const GridGeometry *geometry);
+gint grid_geometry_cell_at(const GridGeometry *geometry, gint rows, gint x, gint y);
+
+/* Continuous scroll view */
+void scroll_view_new(LauncherPlugin *launcher);
+void scroll_view_free(LauncherPlugin *launcher);
+void scroll_view_populate(LauncherPlugin *launcher);
+void scroll_view_update_extent(LauncherPlugin *launcher);
+void scroll_view_reset(LauncherPlugin *launcher);
+guint scroll_view_get_first_index(LauncherPlugin *launcher);
+guint scroll_view_get_end_index(LauncherPlugin *launcher);
+
+/* Icon surface cache */
+void icon_cache_new(Catalog *catalog);
+void icon_cache_free(Catalog *catalog);
+cairo_surface_t* icon_cache_lookup(LauncherPlugin *launcher, const gchar *icon_name,
+                                   gint size, gint scale);
+void icon_cache_preload(LauncherPlugin *launcher, GPtrArray *apps);
+void icon_cache_write_atlas(Catalog *catalog, gboolean async);
+
+/* Persistent icon atlas */
+typedef struct {
+    gchar *name;
+    gchar *filename;
+    gint64 mtime;
+    cairo_surface_t *surface;
+} AtlasIcon;
+
+gchar* icon_atlas_get_path(gint size, gint scale);
+gchar* icon_atlas_get_theme_name(void);
+gint64 icon_atlas_file_mtime(const gchar *filename);
+IconAtlas* icon_atlas_open(gint size, gint scale, const gchar *theme_name);
+void icon_atlas_free(IconAtlas *atlas);
+cairo_surface_t* icon_atlas_lookup(IconAtlas *atlas, const gchar *icon_name,
+                                   const gchar **filename, gint64 *mtime);
+void atlas_icon_free(AtlasIcon *icon);
+void icon_atlas_save(gint size, gint scale, const gchar *theme_name, GPtrArray *icons);
+void icon_atlas_save_async(gint size, gint scale, const gchar *theme_name, GPtrArray *icons);
+
+/* Search index */
+SearchIndex* search_index_new(void);
+void search_index_free(SearchIndex *index);
+void search_index_invalidate(Catalog *catalog);
+GPtrArray* search_index_query(LauncherPlugin *launcher, const gchar *text);
+AppInfo* search_index_dominant_match(LauncherPlugin *launcher);
+
+/* Launch history */
+gchar* launch_history_get_path(void);
+void launch_history_load(Catalog *catalog);
+void launch_history_free(Catalog *catalog);
+void launch_history_record(LauncherPlugin *launcher, const gchar *desktop_id);
+gdouble launch_history_score(LauncherPlugin *launcher, const gchar *desktop_id);
+GList* launch_history_top(LauncherPlugin *launcher, guint max_apps);
+
+/* Predictive warm-up and launch statistics */
+void prewarm_new(Catalog *catalog);
+void prewarm_free(Catalog *catalog);
+void prewarm_disable(Catalog *catalog);
+void prewarm_recent_applications(LauncherPlugin *launcher);
+void prewarm_application(LauncherPlugin *launcher, AppInfo *app_info);
+void prewarm_watch_launch(LauncherPlugin *launcher, AppInfo *app_info, GAppLaunchContext *context);
+
+/* Timing instrumentation */
+typedef enum {
+    TRACE_LOAD_APPLICATIONS,
+    TRACE_DISCOVER_ENUMERATE,   /* listing and de-duplicating the desktop files */
+    TRACE_DISCOVER_PARSE,
+    TRACE_LOAD_CONFIGURATION,
+    TRACE_CREATE_OVERLAY,
+    TRACE_POPULATE_PAGE,
+    TRACE_SEARCH,
+    TRACE_LAUNCH,
+    TRACE_LAUNCH_SPAWN,         /* click until the process was spawned */
+    TRACE_CONSTRUCT,
+    TRACE_PANEL_VISIBLE,        /* construction until the button is first drawn */
+    TRACE_N_PROBES
+} TraceProbe;
+
+gint64 trace_begin(void);
+void trace_end(TraceProbe probe, gint64 start);
+gchar* trace_report(void);
+void trace_export(void);
 
 /* Event handlers */
 gboolean on_key_press(GtkWidget *widget, GdkEventKey *event, LauncherPlugin *launcher);
@@ -139,9 +359,26 @@ void remove_app_from_folder(LauncherPlugin *launcher, AppInfo *app);
 
 /* Configuration */
 gchar* get_config_file_path(void);
+gchar* config_build_snapshot(Catalog *catalog, guint generation);
+gchar* config_layout_get_path(void);
+GByteArray* config_layout_build(Catalog *catalog, guint generation);
+gchar* config_layout_to_xml(const GByteArray *data);
+gboolean config_layout_load(LauncherPlugin *launcher, guint *generation);
+AppInfo* config_find_app(Catalog *catalog, GHashTable **by_name, const gchar *desktop_id,
+                         const gchar *name);
 void save_configuration(LauncherPlugin *launcher);
 void load_configuration(LauncherPlugin *launcher);
 
+/* Configuration journal */
+void config_record_hide(LauncherPlugin *launcher, AppInfo *app);
+void config_record_move(LauncherPlugin *launcher, AppInfo *app, guint index);
+void config_record_folder(LauncherPlugin *launcher, FolderInfo *folder);
+void config_record_file(LauncherPlugin *launcher, AppInfo *app, const gchar *folder_id);
+void config_store_compact(Catalog *catalog);
+void config_store_replay(LauncherPlugin *launcher, guint generation);
+void config_store_sync(Catalog *catalog);
+void config_store_free(Catalog *catalog);
+
 /* Plugin lifecycle callbacks */
 void launcher_button_clicked(GtkWidget *button, LauncherPlugin *launcher);
 void launcher_orientation_changed(XfcePanelPlugin *plugin, GtkOrientation orientation, LauncherPlugin *launcher);